@@ -1,18 +1,36 @@
 #include <getopt.h>
+#include <glob.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #include <cbs.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <default_params.hpp>
 #include <ecbs.hpp>
+#include <fstream>
 #include <hca.hpp>
 #include <icbs.hpp>
 #include <iostream>
 #include <ir.hpp>
+#include <list>
+#include <mapped_file.hpp>
 #include <pibt.hpp>
 #include <pibt_complete.hpp>
+#include <pibt_lifelong.hpp>
+#include <pibt_parallel.hpp>
 #include <problem.hpp>
 #include <push_and_swap.hpp>
 #include <random>
+#include <result.hpp>
 #include <revisit_pp.hpp>
+#include <scenario.hpp>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <whca.hpp>
 #include <winpibt.hpp>
@@ -20,6 +38,15 @@
 void printHelp();
 std::unique_ptr<Solver> getSolver(const std::string solver_name, Problem* P,
                                   bool verbose, int argc, char* argv[]);
+std::vector<std::string> expandInstancePatterns(
+    const std::vector<std::string>& patterns);
+std::vector<int> parseAgentsList(const std::string& list);
+int runBatch(const std::vector<std::string>& instances,
+             const std::vector<int>& agents_list,
+             const std::string& output_dir, const std::string& solver_name,
+             bool verbose, int max_comp_time, int workers, int argc,
+             char* argv[]);
+int runDaemon(const std::string& socket_path, bool verbose);
 
 int main(int argc, char* argv[])
 {
@@ -38,15 +65,28 @@ int main(int argc, char* argv[])
       {"help", no_argument, 0, 'h'},
       {"time-limit", required_argument, 0, 'T'},
       {"make-scen", no_argument, 0, 'P'},
+      {"batch", required_argument, 0, 'b'},
+      {"workers", required_argument, 0, 'W'},
+      {"daemon", no_argument, 0, 'D'},
+      {"socket", required_argument, 0, 'U'},
+      {"convert", required_argument, 0, 'C'},
+      {"agents", required_argument, 0, 'A'},
       {0, 0, 0, 0},
   };
   bool make_scen = false;
   int max_comp_time = -1;
+  std::vector<std::string> batch_patterns;
+  bool output_given = false;
+  int workers = std::max(1, (int)std::thread::hardware_concurrency());
+  bool daemon = false;
+  std::string socket_path = "";  // empty -> stdin/stdout
+  std::string convert_file = "";  // binary result
+  std::string agents_str = "";    // numbers of agents of scenarios
 
   // command line args
   int opt, longindex;
   opterr = 0;  // ignore getopt error
-  while ((opt = getopt_long(argc, argv, "i:o:s:vhPT:", longopts, &longindex)) !=
+  while ((opt = getopt_long(argc, argv, "i:o:s:vhPT:b:W:DU:C:A:", longopts, &longindex)) !=
          -1) {
     switch (opt) {
       case 'i':
@@ -54,6 +94,7 @@ int main(int argc, char* argv[])
         break;
       case 'o':
         output_file = std::string(optarg);
+        output_given = true;
         break;
       case 's':
         solver_name = std::string(optarg);
@@ -70,11 +111,60 @@ int main(int argc, char* argv[])
       case 'T':
         max_comp_time = std::atoi(optarg);
         break;
+      case 'b':
+        batch_patterns.push_back(std::string(optarg));
+        break;
+      case 'W':
+        workers = std::max(1, std::atoi(optarg));
+        break;
+      case 'D':
+        daemon = true;
+        break;
+      case 'U':
+        daemon = true;
+        socket_path = std::string(optarg);
+        break;
+      case 'C':
+        convert_file = std::string(optarg);
+        break;
+      case 'A':
+        agents_str = std::string(optarg);
+        break;
       default:
         break;
     }
   }
 
+  // binary result -> text result
+  if (!convert_file.empty()) {
+    try {
+      ResultReader(convert_file).writeText(output_file);
+    } catch (const MAPFError& e) {
+      std::cout << e.what() << std::endl;
+      return 1;
+    }
+    if (verbose) std::cout << "save result as " << output_file << std::endl;
+    return 0;
+  }
+
+  // requests are given by the line protocol
+  if (daemon) return runDaemon(socket_path, verbose);
+
+  std::vector<int> agents_list;
+  try {
+    agents_list = parseAgentsList(agents_str);
+  } catch (const MAPFError& e) {
+    std::cout << e.what() << std::endl;
+    return 1;
+  }
+
+  // batch mode, -o specifies the output directory
+  if (!batch_patterns.empty()) {
+    return runBatch(expandInstancePatterns(batch_patterns), agents_list,
+                    output_given ? output_file : ".", solver_name, verbose,
+                    max_comp_time, workers, argc, argv_copy);
+  }
+
   if (instance_file.length() == 0) {
     std::cout << "specify instance file using -i [INSTANCE-FILE], e.g.,"
               << std::endl;
@@ -82,31 +172,47 @@ int main(int argc, char* argv[])
     return 0;
   }
 
-  // set problem
-  Problem P = Problem(instance_file);
+  // errors are reported by exceptions
+  try {
+    // set problem
+    std::unique_ptr<Problem> P;
+    if (Scenario::isScenFile(instance_file)) {
+      if (agents_list.size() > 1) {
+        throw MAPFError("error@app: use batch mode for multiple -A");
+      }
+      Scenario scen(instance_file);
+      P = std::make_unique<Problem>(
+          scen, agents_list.empty() ? scen.getSize() : agents_list[0]);
+    } else {
+      P = std::make_unique<Problem>(instance_file);
+    }
 
-  // set max computation time (otherwise, use param in instance_file)
-  if (max_comp_time != -1) P.setMaxCompTime(max_comp_time);
+    // set max computation time (otherwise, use param in instance_file)
+    if (max_comp_time != -1) P->setMaxCompTime(max_comp_time);
 
-  // create scenario
-  if (make_scen) {
-    P.makeScenFile(output_file);
-    return 0;
-  }
+    // create scenario
+    if (make_scen) {
+      P->makeScenFile(output_file);
+      return 0;
+    }
 
-  // solve
-  auto solver = getSolver(solver_name, &P, verbose, argc, argv_copy);
-  solver->solve();
-  if (solver->succeed() && !solver->getSolution().validate(&P)) {
-    std::cout << "error@app: invalid results" << std::endl;
-    return 0;
-  }
-  solver->printResult();
+    // solve
+    auto solver = getSolver(solver_name, P.get(), verbose, argc, argv_copy);
+    solver->solve();
+    if (solver->succeed() && !solver->validateSolution()) {
+      std::cout << "error@app: invalid results" << std::endl;
+      return 0;
+    }
+    solver->printResult();
 
-  // output result
-  solver->makeLog(output_file);
-  if (verbose) {
-    std::cout << "save result as " << output_file << std::endl;
+    // output result
+    solver->makeLog(output_file);
+    if (verbose) {
+      std::cout << "save result as " << output_file << std::endl;
+    }
+  } catch (const MAPFError& e) {
+    std::cout << e.what() << std::endl;
+    return 1;
   }
 
   return 0;
@@ -128,6 +234,10 @@ std::unique_ptr<Solver> getSolver(const std::string solver_name, Problem* P,
     solver = std::make_unique<CBS>(P);
   } else if (solver_name == "ICBS") {
     solver = std::make_unique<ICBS>(P);
+  } else if (solver_name == "PIBT_LIFELONG") {
+    solver = std::make_unique<PIBT_LIFELONG>(P);
+  } else if (solver_name == "PIBT_PARALLEL") {
+    solver = std::make_unique<PIBT_PARALLEL>(P);
   } else if (solver_name == "PIBT_COMPLETE") {
     solver = std::make_unique<PIBT_COMPLETE>(P);
   } else if (solver_name == "ECBS") {
@@ -150,29 +260,532 @@ std::unique_ptr<Solver> getSolver(const std::string solver_name, Problem* P,
     solver = std::make_unique<IR_BOTTLENECK>(P);
   } else if (solver_name == "IR_HYBRID") {
     solver = std::make_unique<IR_HYBRID>(P);
+  } else if (solver_name == "IR_ADAPTIVE") {
+    solver = std::make_unique<IR_ADAPTIVE>(P);
   } else {
     std::cout << "warn@app: "
               << "unknown solver name, " + solver_name + ", continue by PIBT"
               << std::endl;
     solver = std::make_unique<PIBT>(P);
   }
-  solver->setParams(argc, argv);
+  {
+    std::lock_guard<std::mutex> lock(Solver::option_mtx);
+    solver->setParams(argc, argv);
+  }
   solver->setVerbose(verbose);
   return solver;
 }
 
+std::vector<std::string> expandInstancePatterns(
+    const std::vector<std::string>& patterns)
+{
+  std::vector<std::string> instances;
+  for (auto pattern : patterns) {
+    glob_t glob_result;
+    // unmatched patterns are kept, then reported as errors of the instance
+    if (glob(pattern.c_str(), GLOB_NOCHECK, nullptr, &glob_result) == 0) {
+      for (size_t i = 0; i < glob_result.gl_pathc; ++i) {
+        instances.push_back(std::string(glob_result.gl_pathv[i]));
+      }
+    }
+    globfree(&glob_result);
+  }
+  return instances;
+}
+
+// e.g., "50,100" or "50:1500:50" (from:to:step), empty -> no numbers
+std::vector<int> parseAgentsList(const std::string& list)
+{
+  std::vector<int> agents_list;
+  std::istringstream iss(list);
+  for (std::string item; getline(iss, item, ',');) {
+    std::vector<int> nums;
+    std::istringstream iss_item(item);
+    for (std::string num; getline(iss_item, num, ':');) {
+      const bool digits =
+          !num.empty() && std::all_of(num.begin(), num.end(), ::isdigit);
+      nums.push_back(digits ? std::atoi(num.c_str()) : 0);
+    }
+    const int from = nums.empty() ? 0 : nums[0];
+    const int to = (nums.size() >= 2) ? nums[1] : from;
+    const int step = (nums.size() >= 3) ? nums[2] : 1;
+    if (nums.size() > 3 || from <= 0 || to < from || step <= 0) {
+      throw MAPFError("error@app: invalid number of agents, " + item);
+    }
+    for (int n = from; n <= to; n += step) agents_list.push_back(n);
+  }
+  return agents_list;
+}
+
+int runBatch(const std::vector<std::string>& instances,
+             const std::vector<int>& agents_list,
+             const std::string& output_dir, const std::string& solver_name,
+             bool verbose, int max_comp_time, int workers, int argc,
+             char* argv[])
+{
+  // scenarios are parsed once, then shared by the jobs of all numbers
+  // of agents, read-only in workers
+  struct Job {
+    std::string instance;
+    std::string name;          // printed and written to the summary
+    const Scenario* scen;      // nullptr -> instance format
+    int num_agents;            // for scenarios
+    std::string error;
+  };
+  std::vector<Job> jobs;
+  std::vector<std::unique_ptr<Scenario>> scenarios;
+  for (auto& instance : instances) {
+    if (!Scenario::isScenFile(instance)) {
+      jobs.push_back({instance, instance, nullptr, 0, ""});
+      continue;
+    }
+    try {
+      scenarios.push_back(std::make_unique<Scenario>(instance));
+    } catch (const MAPFError& e) {
+      jobs.push_back({instance, instance, nullptr, 0, e.what()});
+      continue;
+    }
+    auto scen = scenarios.back().get();
+    for (auto num : agents_list.empty() ? std::vector<int>{scen->getSize()}
+                                        : agents_list) {
+      jobs.push_back({instance, instance + ":" + std::to_string(num), scen,
+                      num, ""});
+    }
+  }
+
+  struct Result {
+    int num_agents = 0;
+    bool solved = false;
+    std::string solver;
+    int comp_time = 0;
+    int soc = 0;
+    int soc_lb = 0;
+    int makespan = 0;
+    int makespan_lb = 0;
+    std::string output_file;
+    std::string error;
+  };
+  const int jobs_num = jobs.size();
+  std::vector<Result> results(jobs_num);
+  std::atomic<int> next(0);
+  std::mutex print_mtx;
+
+  // e.g., result_arena-even-1_300agents.txt,
+  // the job index is added to names shared by several jobs,
+  // e.g., a/x.txt and b/x.txt -> result_x_0.txt and result_x_1.txt
+  std::vector<std::string> output_files(jobs_num);
+  std::unordered_map<std::string, int> names_cnt;
+  for (int k = 0; k < jobs_num; ++k) {
+    auto& job = jobs[k];
+    auto pos = job.instance.find_last_of('/');
+    auto name = (pos == std::string::npos) ? job.instance
+                                           : job.instance.substr(pos + 1);
+    if (job.scen != nullptr) {
+      name = name.substr(0, name.size() - 5) + "_" +
+             std::to_string(job.num_agents) + "agents.txt";
+    }
+    output_files[k] = name;
+    ++names_cnt[name];
+  }
+  for (int k = 0; k < jobs_num; ++k) {
+    auto& name = output_files[k];
+    if (names_cnt[name] > 1) {
+      auto pos = name.find_last_of('.');
+      if (pos == std::string::npos) pos = name.size();
+      name = name.substr(0, pos) + "_" + std::to_string(k) + name.substr(pos);
+    }
+    name = output_dir + "/result_" + name;
+  }
+
+  auto work = [&]() {
+    // graphs are shared between instances of the same map in this worker
+    GraphTable graphs;
+    for (int k = next++; k < jobs_num; k = next++) {
+      auto& job = jobs[k];
+      auto& res = results[k];
+      res.num_agents = job.num_agents;
+      try {
+        if (!job.error.empty()) throw MAPFError(job.error);
+        auto P = (job.scen == nullptr)
+                     ? std::make_unique<Problem>(job.instance, &graphs)
+                     : std::make_unique<Problem>(*job.scen, job.num_agents,
+                                                 &graphs);
+        if (max_comp_time != -1) P->setMaxCompTime(max_comp_time);
+        res.num_agents = P->getNum();
+        auto solver = getSolver(solver_name, P.get(), verbose, argc, argv);
+        solver->solve();
+        if (solver->succeed() && !solver->validateSolution()) {
+          throw MAPFError("error@app: invalid results");
+        }
+        res.solved = solver->succeed();
+        res.solver = solver->getSolverName();
+        res.comp_time = solver->getCompTime();
+        res.soc = solver->getSolution().getSOC();
+        res.soc_lb = solver->getLowerBoundSOC();
+        res.makespan = solver->getSolution().getMakespan();
+        res.makespan_lb = solver->getLowerBoundMakespan();
+        res.output_file = output_files[k];
+        solver->makeLog(res.output_file);
+        std::lock_guard<std::mutex> lock(print_mtx);
+        std::cout << job.name << ": ";
+        solver->printResult();
+      } catch (const MAPFError& e) {
+        res.error = e.what();
+        std::lock_guard<std::mutex> lock(print_mtx);
+        std::cout << job.name << ": " << e.what() << std::endl;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < std::min(workers, jobs_num); ++i) {
+    threads.emplace_back(work);
+  }
+  for (auto& th : threads) th.join();
+
+  // summary
+  const std::string summary_file = output_dir + "/summary.csv";
+  std::ofstream log(summary_file);
+  if (!log) {
+    std::cout << "error@app: cannot write " << summary_file << std::endl;
+    return 1;
+  }
+  log << "instance,agents,solver,solved,comp_time,soc,soc_lb,makespan,makespan_lb,"
+      << "result_file,error\n";
+  int solved_num = 0;
+  for (int k = 0; k < jobs_num; ++k) {
+    auto& res = results[k];
+    if (res.solved) ++solved_num;
+    log << jobs[k].instance << "," << res.num_agents << "," << res.solver << "," << res.solved << ","
+        << res.comp_time << "," << res.soc << "," << res.soc_lb << ","
+        << res.makespan << "," << res.makespan_lb << "," << res.output_file
+        << ",\"" << res.error << "\"\n";
+  }
+  log.close();
+  std::cout << "solved " << solved_num << "/" << jobs_num
+            << ", save summary as " << summary_file << std::endl;
+  return 0;
+}
+
+// streambuf of a file descriptor, used for unix domain sockets
+class FdStreamBuf : public std::streambuf
+{
+private:
+  const int fd;
+  char buf_in[4096];
+  char buf_out[4096];
+
+protected:
+  int_type underflow()
+  {
+    const ssize_t n = read(fd, buf_in, sizeof(buf_in));
+    if (n <= 0) return traits_type::eof();
+    setg(buf_in, buf_in, buf_in + n);
+    return traits_type::to_int_type(*gptr());
+  }
+
+  int_type overflow(int_type c)
+  {
+    if (sync() == -1) return traits_type::eof();
+    if (c != traits_type::eof()) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  int sync()
+  {
+    for (char* p = pbase(); p < pptr();) {
+      const ssize_t n = write(fd, p, pptr() - p);
+      if (n <= 0) return -1;
+      p += n;
+    }
+    setp(buf_out, buf_out + sizeof(buf_out));
+    return 0;
+  }
+
+public:
+  FdStreamBuf(int _fd) : fd(_fd)
+  {
+    setg(buf_in, buf_in, buf_in);
+    setp(buf_out, buf_out + sizeof(buf_out));
+  }
+};
+
+// kept between requests, key: map_file:max_timestep
+// caches of the daemon, per map and max_timestep
+// the least recently used ones are removed beyond the limits
+struct DaemonCache {
+  GraphTable graphs;
+  std::unordered_map<std::string, Solver::DistanceCache> distance_tables;
+  std::unordered_map<std::string, Solver::MDDTable> mdd_tables;
+  std::list<std::string> keys;  // in order of use, the last is the latest
+
+  static constexpr long long MAX_DISTANCE_ENTRIES = 1LL << 26;  // 256 MB
+  static constexpr int MAX_MDDS = 100000;
+
+  void use(const std::string& key)
+  {
+    keys.remove(key);
+    keys.push_back(key);
+  }
+
+  void clear()
+  {
+    graphs.clear();
+    distance_tables.clear();
+    mdd_tables.clear();
+    keys.clear();
+  }
+
+  // called after each request
+  void shrink()
+  {
+    auto getSize = [&]() {
+      long long distance_entries = 0;
+      long long mdds = 0;
+      for (auto& itr : distance_tables) {
+        for (auto& row : itr.second) distance_entries += row.second.size();
+      }
+      for (auto& itr : mdd_tables) mdds += itr.second.size();
+      return std::make_tuple(distance_entries, mdds);
+    };
+    while (!keys.empty()) {
+      const auto [distance_entries, mdds] = getSize();
+      if (distance_entries <= MAX_DISTANCE_ENTRIES && mdds <= MAX_MDDS) break;
+      // graphs are kept, MDDs refer to their nodes
+      distance_tables.erase(keys.front());
+      mdd_tables.erase(keys.front());
+      keys.pop_front();
+    }
+  }
+};
+
+// handle requests until "quit" (return false) or the end of input (true)
+bool serveRequests(std::istream& in, std::ostream& out, DaemonCache* cache,
+                   bool verbose)
+{
+  // request
+  std::string map_file, solver_name, options, error;
+  int seed, max_timestep, max_comp_time;
+  std::vector<std::vector<int>> starts_goals;
+  auto reset = [&]() {
+    map_file = solver_name = options = error = "";
+    seed = DEFAULT_SEED;
+    max_timestep = DEFAULT_MAX_TIMESTEP;
+    max_comp_time = DEFAULT_MAX_COMP_TIME;
+    starts_goals.clear();
+  };
+  reset();
+
+  std::string line;
+  while (getline(in, line)) {
+    if (!line.empty() && line.back() == 0x0d) line.pop_back();
+    if (line.empty() || line[0] == '#') continue;
+    if (line == "quit") return false;
+    if (line == "clear") {
+      cache->clear();
+      out << "end" << std::endl;
+      continue;
+    }
+    if (line != "solve") {
+      // the first error of the request is reported by solve
+      auto setError = [&](const std::string& msg) {
+        if (error.empty()) error = "error@app: " + msg + ", " + line;
+      };
+      const char* l = line.c_str();
+      const char* e = l + line.size();
+      const auto eq = line.find('=');
+      if (eq != std::string::npos) {
+        const std::string key = line.substr(0, eq);
+        const std::string val = line.substr(eq + 1);
+        const char* v = l + eq + 1;
+        if (key == "map_file" && !val.empty()) {
+          map_file = val;
+        } else if (key == "solver" && !val.empty()) {
+          solver_name = val;
+        } else if (key == "options") {
+          options = val;
+        } else if (key == "seed") {
+          if (!parseUInt(v, e, seed)) setError("invalid value");
+        } else if (key == "max_timestep") {
+          if (!parseUInt(v, e, max_timestep)) setError("invalid value");
+        } else if (key == "max_comp_time") {
+          if (!parseUInt(v, e, max_comp_time)) setError("invalid value");
+        } else {
+          setError("unknown line");
+        }
+        continue;
+      }
+      // "x_s,y_s,x_g,y_g"
+      std::vector<int> sg(4);
+      bool matched = true;
+      for (int k = 0; k < 4 && matched; ++k) {
+        const char* q =
+            (k < 3) ? static_cast<const char*>(std::memchr(l, ',', e - l)) : e;
+        matched = (q != nullptr) && parseUInt(l, q, sg[k]);
+        if (matched) l = q + 1;
+      }
+      if (matched) {
+        starts_goals.push_back(sg);
+      } else {
+        setError("unknown line");
+      }
+      continue;
+    }
+
+    // solve
+    auto t_s = Time::now();
+    try {
+      if (!error.empty()) throw MAPFError(error);
+      if (map_file.empty()) throw MAPFError("error@app: no map_file");
+      Graph* G = Problem::getGraph(map_file, &cache->graphs);
+      Config config_s, config_g;
+      for (auto& sg : starts_goals) {
+        if (!G->existNode(sg[0], sg[1]) || !G->existNode(sg[2], sg[3])) {
+          throw MAPFError("error@app: invalid start or goal");
+        }
+        config_s.push_back(G->getNode(sg[0], sg[1]));
+        config_g.push_back(G->getNode(sg[2], sg[3]));
+      }
+      Problem P =
+          Problem(G, config_s, config_g, max_comp_time, max_timestep, seed);
+
+      // solver options are split by spaces, argv[0] is not used
+      std::vector<std::string> args = {""};
+      std::istringstream iss(options);
+      for (std::string arg; iss >> arg;) args.push_back(arg);
+      std::vector<char*> argv;
+      for (auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+      auto solver =
+          getSolver(solver_name, &P, verbose, argv.size(), argv.data());
+
+      // warm caches
+      const auto key = map_file + ":" + std::to_string(max_timestep);
+      cache->use(key);
+      solver->setDistanceCache(&cache->distance_tables[key]);
+      solver->setMDDTable(&cache->mdd_tables[key]);
+
+      solver->solve();
+      if (solver->succeed() && !solver->validateSolution()) {
+        throw MAPFError("error@app: invalid results");
+      }
+      solver->writeLog(out);
+      out << "elapsed=" << getElapsedTime(t_s) << "\n";
+    } catch (const MAPFError& e) {
+      out << "error=" << e.what() << "\n";
+    } catch (const std::exception& e) {
+      // e.g., bad_alloc, the server keeps running
+      out << "error=error@app: " << e.what() << "\n";
+    }
+    out << "end" << std::endl;
+    cache->shrink();
+    reset();
+  }
+  return true;
+}
+
+int runDaemon(const std::string& socket_path, bool verbose)
+{
+  DaemonCache cache;
+
+  // stdin/stdout, messages of solvers are moved to stderr
+  if (socket_path.empty()) {
+    std::ostream out(std::cout.rdbuf());
+    auto cout_buf = std::cout.rdbuf(std::cerr.rdbuf());
+    serveRequests(std::cin, out, &cache, verbose);
+    std::cout.rdbuf(cout_buf);
+    return 0;
+  }
+
+  // unix domain socket, connections are handled one by one
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (fd < 0 || socket_path.size() >= sizeof(addr.sun_path)) {
+    std::cout << "error@app: cannot create socket " << socket_path << std::endl;
+    return 1;
+  }
+  socket_path.copy(addr.sun_path, socket_path.size());
+  unlink(socket_path.c_str());
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+    std::cout << "error@app: cannot bind " << socket_path << std::endl;
+    close(fd);
+    return 1;
+  }
+  signal(SIGPIPE, SIG_IGN);  // clients may disconnect while writing
+  if (verbose) std::cout << "listen " << socket_path << std::endl;
+
+  bool running = true;
+  int backoff = 0;  // ms, while running out of descriptors or memory
+  while (running) {
+    const int conn = accept(fd, nullptr, nullptr);
+    if (conn < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS ||
+          errno == ENOMEM) {
+        backoff = std::min(std::max(2 * backoff, 10), 1000);
+        if (verbose) std::cout << "accept: " << strerror(errno) << std::endl;
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+        continue;
+      }
+      std::cout << "error@app: cannot accept, " << strerror(errno)
+                << std::endl;
+      close(fd);
+      unlink(socket_path.c_str());
+      return 1;
+    }
+    backoff = 0;
+    FdStreamBuf buf(conn);
+    std::istream in(&buf);
+    std::ostream out(&buf);
+    running = serveRequests(in, out, &cache, verbose);
+    out.flush();
+    close(conn);
+  }
+  close(fd);
+  unlink(socket_path.c_str());
+  return 0;
+}
+
 void printHelp()
 {
   std::cout << "\nUsage: ./app [OPTIONS] [SOLVER-OPTIONS]\n"
             << "\n**instance file is necessary to run MAPF simulator**\n\n"
-            << "  -i --instance [FILE_PATH]     instance file path\n"
-            << "  -o --output [FILE_PATH]       ouptut file path\n"
+            << "  -i --instance [FILE_PATH]     instance file path, or .scen\n"
+            << "  -o --output [FILE_PATH]       ouptut file path, "
+               ".bin or .binz -> binary\n"
             << "  -v --verbose                  print additional info\n"
             << "  -h --help                     help\n"
             << "  -s --solver [SOLVER_NAME]     solver, choose from the below\n"
             << "  -T --time-limit [INT]         max computation time (ms)\n"
             << "  -P --make-scen                make scenario file using "
-               "random starts/goals"
+               "random starts/goals\n"
+            << "  -b --batch [FILE_PATTERN]     solve instances matching the "
+               "pattern,\n"
+            << "                                repeatable, -o gives the "
+               "output directory\n"
+            << "  -W --workers [INT]            number of parallel instances "
+               "in batch mode\n"
+            << "  -D --daemon                   serve requests on stdin/stdout\n"
+            << "  -U --socket [FILE_PATH]       serve requests on a unix "
+               "domain socket\n"
+            << "  -C --convert [FILE_PATH]      convert a binary result "
+               "to the text format,\n"
+            << "                                -o gives the output file\n"
+            << "  -A --agents [LIST]            numbers of agents of .scen "
+               "instances, e.g.,\n"
+            << "                                300 or 50:1500:50,2000, "
+               "default: all\n"
+            << "\nDaemon Requests: lines of the instance format, i.e., "
+               "map_file=,\n"
+            << "  max_timestep=, max_comp_time=, seed=, x_s,y_s,x_g,y_g, "
+               "plus solver=\n"
+            << "  and options=[SOLVER-OPTIONS], then 'solve'. The result "
+               "log ends with 'end'.\n"
+            << "  'clear' drops cached maps and distances, 'quit' stops the "
+               "daemon."
             << "\n\nSolver Options:" << std::endl;
   // each solver
   PIBT::printHelp();
@@ -185,6 +798,8 @@ void printHelp()
   ECBS::printHelp();
   ICBS::printHelp();
   PIBT_COMPLETE::printHelp();
+  PIBT_LIFELONG::printHelp();
+  PIBT_PARALLEL::printHelp();
   IR::printHelp();
   IR_SINGLE_PATHS::printHelp();
   IR_FIX_AT_GOALS::printHelp();
@@ -192,4 +807,5 @@ void printHelp()
   IR_MDD::printHelp();
   IR_BOTTLENECK::printHelp();
   IR_HYBRID::printHelp();
+  IR_ADAPTIVE::printHelp();
 }
@@ -0,0 +1,59 @@
+/*
+ * Cooperative cancellation passed down the solver hierarchy
+ *
+ * A token stops when it is cancelled, when its deadline passes,
+ * or when one of its ancestors stops.
+ * Nested solvers use child tokens, so stopping a parent stops all of them,
+ * while cancelling a child leaves the parent and its siblings running.
+ * Tokens are thread-safe.
+ */
+
+#pragma once
+#include <atomic>
+#include <memory>
+
+#include "util.hpp"
+
+class CancelToken
+{
+private:
+  const std::shared_ptr<CancelToken> parent;
+  std::atomic<bool> cancelled;
+  const Time::time_point deadline;  // already min with the ancestors
+
+public:
+  // without parent and deadline, e.g., for problem instances
+  CancelToken();
+  // deadline of the parent is inherited
+  CancelToken(std::shared_ptr<CancelToken> _parent);
+  CancelToken(std::shared_ptr<CancelToken> _parent,
+              const Time::time_point _deadline);
+
+  void cancel() { cancelled = true; }
+  bool isCancelled() const;  // by itself or ancestors, without the clock
+  bool isExpired() const;    // cancelled or over the deadline
+  bool isExpired(const Time::time_point now) const;
+
+  bool hasDeadline() const { return deadline != Time::time_point::max(); }
+  Time::time_point getDeadline() const { return deadline; }
+  int getRemainedTime() const;  // ms, -1 -> no deadline
+};
+
+/*
+ * used in inner loops, e.g., expansions of search,
+ * the clock is read only once every INTERVAL calls
+ */
+class CancelPoller
+{
+private:
+  static constexpr int INTERVAL = 64;
+  const CancelToken* const token;  // nullptr -> only the time limit
+  const Time::time_point deadline;
+  int count;
+
+public:
+  // time_limit: ms, non-positive -> no limit
+  CancelPoller(const CancelToken* const _token, const int time_limit = -1);
+
+  bool stop();
+};
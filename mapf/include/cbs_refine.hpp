@@ -5,6 +5,7 @@
 
 #pragma once
 #include "cbs.hpp"
+#include "reservation_table.hpp"
 
 class CBS_REFINE : public virtual CBS
 {
@@ -15,6 +16,13 @@ protected:
   const int ub_soc;                   // sum of costs in the old plan
   const std::vector<int> modif_list;  // a modification list M
   std::vector<int> fixed_agents;      // A \ modif_list
+  ReservationTable reserved;          // paths of fixed_agents
+  std::vector<bool> table_goals;      // whether goals of others or not
+
+  // reservation used in collision checks, default: &reserved
+  // sub-problems refer to the reservation of the whole plan instead
+  const ReservationTable* reserved_p;
+  std::vector<int> reserved_ignored;  // agents to be ignored in reserved_p
 
   // true -> makespan optimization, default: false
   // notice: SOC and makespan are Pareto structure.
@@ -25,9 +33,19 @@ protected:
   Path getInitialPath(int id);
   CompareHighLevelNodes getObjective();
 
+  // check collisions with fixed agents
+  bool isConflictedWithFixedAgents(AstarNode* m) const;
+  // whether v is a goal of agents other than a_id
+  bool isOthersGoal(const int id, Node* const v) const;
+
 public:
   CBS_REFINE(Problem* _P, const Plan& _old_plan,
              const std::vector<int>& _modif_list);
+  // for sub-problems, all agents in _P are modified
+  // _ignored: sorted ids of agents in _P within the reservation
+  CBS_REFINE(Problem* _P, const Plan& _old_plan,
+             const ReservationTable* _reserved_p,
+             const std::vector<int>& _ignored);
   ~CBS_REFINE(){};
 
   void setParams(int argc, char* argv[]);
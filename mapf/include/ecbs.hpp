@@ -67,7 +67,7 @@ protected:
   float sub_optimality;
   static const float DEFAULT_SUB_OPTIMALITY;
 
-  void setInitialHighLevelNode(HighLevelNode_p n);
+  virtual void setInitialHighLevelNode(HighLevelNode_p n);
   Path getInitialPath(int id, const Paths& paths);
 
   // objective for open list
@@ -78,7 +78,7 @@ protected:
   void invoke(HighLevelNode_p h_node, int id);
 
   // return path and f-min value
-  std::tuple<Path, int> getFocalPath(HighLevelNode_p h_node, int id);
+  virtual std::tuple<Path, int> getFocalPath(HighLevelNode_p h_node, int id);
   std::tuple<Path, int> getTimedPathByFocalSearch(
       Node* const s, Node* const g, float w,  // sub-optimality
       FocalHeuristics& f1Value, FocalHeuristics& f2Value,
@@ -0,0 +1,44 @@
+/*
+ * Implementation of ECBS for Iterative Refinement
+ * This cannot be used directly
+ *
+ * Bounded-suboptimal alternative to CBS_REFINE for sub-problems.
+ * Only solutions not worse than the old plan are accepted.
+ */
+
+#pragma once
+#include "ecbs.hpp"
+#include "reservation_table.hpp"
+
+class ECBS_REFINE : public ECBS
+{
+public:
+  static const std::string SOLVER_NAME;
+
+private:
+  const int ub_soc;  // sum of costs in the old plan
+
+  // reservation of agents outside of the problem
+  const ReservationTable* const reserved_p;
+  const std::vector<int> reserved_ignored;  // agents to be ignored, sorted
+
+  std::vector<bool> table_goals;  // whether goals of agents in the problem
+
+  // whether v is a goal of agents other than a_id
+  bool isOthersGoal(const int id, Node* const v) const;
+
+  void setInitialHighLevelNode(HighLevelNode_p n);
+  std::tuple<Path, int> getFocalPath(HighLevelNode_p h_node, int id);
+
+  void run();
+
+public:
+  // all agents in _P are replanned
+  // _ignored: sorted ids of agents in _P within the reservation
+  ECBS_REFINE(Problem* _P, const Plan& _old_plan,
+              const ReservationTable* _reserved_p,
+              const std::vector<int>& _ignored);
+  ~ECBS_REFINE() {}
+
+  void setParams(int argc, char* argv[]);
+};
@@ -38,6 +38,8 @@ protected:
 
   virtual void setInitialHighLevelNode(HighLevelNode_p n);
   virtual Path getConstrainedPath(HighLevelNode_p h_node, int id);
+  // create MDD_c^i following constraints of the high-level node
+  virtual LibCBS::MDD_p getConstrainedMDD(HighLevelNode_p h_node, int id, int c);
 
   // prioritized conflict: { cardinal -> semi-cardinal -> non-cardinal }
   virtual LibCBS::Constraints getPrioritizedConflict(HighLevelNode_p h_node);
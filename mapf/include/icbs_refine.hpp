@@ -12,10 +12,14 @@ class ICBS_REFINE : public ICBS, CBS_REFINE
 private:
   void setInitialHighLevelNode(HighLevelNode_p n);
   Path getConstrainedPath(HighLevelNode_p h_node, int id);
+  LibCBS::MDD_p getConstrainedMDD(HighLevelNode_p h_node, int id, int c);
   LibCBS::Constraints getPrioritizedConflict(HighLevelNode_p h_node);
 
 public:
   ICBS_REFINE(Problem* _P, const Plan& _old_plan,
               const std::vector<int>& _modif_list);
+  ICBS_REFINE(Problem* _P, const Plan& _old_plan,
+              const ReservationTable* _reserved_p,
+              const std::vector<int>& _ignored);
   ~ICBS_REFINE(){};
 };
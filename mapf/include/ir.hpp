@@ -4,6 +4,12 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "reservation_table.hpp"
+#include "solution_stream.hpp"
 #include "solver.hpp"
 
 class IR : public Solver
@@ -26,11 +32,40 @@ protected:
   INIT_SOLVER_TYPE init_solver;
   std::vector<std::string> option_init_solver;
 
+  // several init-solvers -> portfolio, they run concurrently by threads,
+  // refinement starts from the first plan and better plans are adopted later
+  std::vector<INIT_SOLVER_TYPE> init_solvers;
+  struct InitPortfolio {
+    std::vector<std::unique_ptr<std::mt19937>> MTs;  // each thread has its own
+    std::vector<std::shared_ptr<Problem>> problems;
+    std::vector<std::shared_ptr<Solver>> solvers;
+    std::vector<std::thread> threads;
+    std::shared_ptr<CancelToken> token;  // child of IR, stop all solvers
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<Plan> plans;  // plans of finished solvers, guarded by mtx
+    int finished_num = 0;     // guarded by mtx
+    int checked_num = 0;      // plans already compared with the solution
+  };
+  std::unique_ptr<InitPortfolio> portfolio;
+
   // refine-solver
-  enum struct OPTIMAL_SOLVER_TYPE { CBS, CBS_NORMAL, ICBS, ICBS_NORMAL };
+  // PP is not optimal but fast, for large sampling sizes
+  // ECBS is bounded-suboptimal, for dense neighborhoods
+  enum struct OPTIMAL_SOLVER_TYPE {
+    CBS,
+    CBS_NORMAL,
+    ICBS,
+    ICBS_NORMAL,
+    PP,
+    ECBS
+  };
   OPTIMAL_SOLVER_TYPE refine_solver;
   std::vector<std::string> option_optimal_solver;
 
+  // true -> retry by ECBS when the refine-solver reaches its time limit
+  bool fallback_suboptimal;
+
   // max iteration
   int current_iteration;
   int max_iteration;
@@ -39,6 +74,9 @@ protected:
   std::string output_file;
   bool make_log_every_itr;  // true -> create log for every iteration
   std::vector<std::tuple<int, int, int>> HIST;  // elapsed timestep, soc, makespan
+  // append-only stream of improvements, empty -> disabled
+  std::string stream_file;
+  std::unique_ptr<SolutionStream> stream;
 
   // early stop
   int timeout_refinement;
@@ -53,22 +91,83 @@ protected:
   //  random sampling
   int sampling_num;
 
+  // reservation of the current solution, used in sub-problems
+  ReservationTable reserved;
+
+  // >1 -> refine disjoint neighborhoods concurrently
+  int thread_num;
+  std::vector<MDDTable> mdd_tables;  // for threads except the first
+
+  // neighborhoods without improvement, name -> fingerprint of inputs
+  // time-limited failures are not recorded, see memorizeNeighborhood
+  std::unordered_map<std::string, size_t> failed_neighborhoods;
+  int skipped_num;  // number of sub-problems skipped by the memo
+  // buffers of getNeighborhoodFingerprint, indexed by node ids
+  struct FingerprintBuffer {
+    std::vector<int> region;   // == region_stamp -> within the region
+    std::vector<int> visited;  // == visit_stamp -> visited by BFS
+    std::vector<int> dist;
+    std::vector<int> t_min;  // time window of each location
+    std::vector<int> t_max;
+    int region_stamp = 0;
+    int visit_stamp = 0;
+  };
+  FingerprintBuffer fingerprint_buffer;
+
   // default params
   static constexpr INIT_SOLVER_TYPE DEFAULT_INIT_SOLVER = IR::INIT_SOLVER_TYPE::PIBT_COMPLETE;
   static constexpr OPTIMAL_SOLVER_TYPE DEFAULT_REFINE_SOLVER = IR::OPTIMAL_SOLVER_TYPE::ICBS;
   static constexpr int DEFAULT_MAX_ITERATION = 100;
   static constexpr int DEFAULT_TIMEOUT_REFINEMENT = 3000;
   static constexpr int DEFAULT_SAMPLING_NUM = 10;
+  static constexpr int DEFAULT_THREAD_NUM = 1;
 
   // main
   void run();
   // update solution
   void updateSolution(const Plan& plan);
+  // synchronize the reservation with a new plan, only changed paths
+  // return: agents whose paths are changed
+  std::vector<int> updateReservation(const Plan& plan);
+  // append the paths of the agents to the stream
+  void pushToStream(const std::vector<int>& ids);
   // use sub-optimal solver to obtain initial solutions
   Plan getInitialPlan();
+  std::shared_ptr<Solver> getInitSolver(Problem* const _P,
+                                        const INIT_SOLVER_TYPE solver_type);
+  static bool getInitSolverType(const std::string& s, INIT_SOLVER_TYPE& type);
+  // start the portfolio and wait for the first plan
+  Plan getInitialPlanByPortfolio();
+  // use a plan of the portfolio if better than the solution, return: adopted?
+  bool adoptBetterInitialPlan();
+  // interrupt remaining init-solvers and wait for them
+  void stopInitPortfolio();
   // use optimal solvers to obtain refined solutions, return: success?, solution
-  std::tuple<bool, Plan> getOptimalPlan(Problem* _P, const Plan& current_plan,
+  // the refine-solver only handles agents in the sample,
+  // current_plan must be the current solution
+  std::tuple<bool, Plan> getOptimalPlan(const Plan& current_plan,
                                         const std::vector<int>& sample);
+  // sub-problem only with agents in the sorted modif_list
+  std::shared_ptr<Problem> getSubProblem(const std::vector<int>& modif_list,
+                                         std::mt19937* const _MT = nullptr);
+  // name of the sorted modif_list, used in the memo
+  static std::string getNeighborhoodName(const std::vector<int>& modif_list);
+  // hash of paths which can affect the refinement of modif_list, i.e.,
+  // paths of modif_list and others visiting locations within their budget
+  // plan must be the current solution, i.e., follow the reservation
+  size_t getNeighborhoodFingerprint(const Plan& plan,
+                                    const std::vector<int>& modif_list);
+  // whether results of the refine-solver can be memorized
+  bool isMemorable() const;
+  // failed with the same fingerprint before? counted as skipped
+  bool isFailedNeighborhood(const std::string& name, const size_t fingerprint);
+  void memorizeNeighborhood(const std::string& name, const size_t fingerprint,
+                            const bool improved, const bool timeout);
+  // refine-solver for the sub-problem, set up with options
+  std::shared_ptr<Solver> getRefineSolver(Problem* const _P,
+                                          const Plan& current_plan,
+                                          const std::vector<int>& modif_list,
+                                          const OPTIMAL_SOLVER_TYPE solver_type);
   // refinement
   virtual void refinePlan();
   // utilities, print current status
@@ -77,6 +176,10 @@ protected:
   // ----------------------------
   // define refinement rules
   void updateByRandom();
+  // pickup num agents randomly and refine them, one iteration
+  void updateByRandomOnce(const int num);
+  // solve several neighborhoods by threads, then commit compatible ones
+  void updateByRandomInParallel();
   // work as macro, pickup one agent and apply a rule
   void updatePlanFocusOneAgent(std::function<void(const int, Plan&, IR*)> fn);
   static void updateBySinglePaths(const int i, Plan& plan, IR* const solver);
@@ -98,6 +201,14 @@ public:
   // used in BOTTLENECK
   static std::tuple<int, std::vector<int>> identifyBottleneckAgentsWithScore
   (const int i, const Paths& original_paths, Solver* const solver, const int time_limit = -1);
+  // used in parallel refinement, sub_plans[k] refines disjoint modif_lists[k]
+  // against plan, empty -> failed; merged in descending order of improvement
+  // unless colliding with already merged ones
+  // return: merged plan, committed indexes, discarded indexes
+  static std::tuple<Plan, std::vector<int>, std::vector<int>>
+  commitImprovements(const Plan& plan,
+                     const std::vector<std::vector<int>>& modif_lists,
+                     const std::vector<Plan>& sub_plans);
 
 public:
   IR(Problem* _P);
@@ -107,12 +218,13 @@ public:
   int getRefineTimeLimit() const { return std::min(getRemainedTime(), timeout_refinement); }
 
   // others
-  void makeLog(const std::string& logfile);
+  void writeLog(std::ostream& log);
   virtual void setParams(int argc, char* argv[]);
   static void printHelp();
 
   // for tests
   void setInitialPlan(const Plan& plan);
+  int getSkippedNum() const { return skipped_num; }
 };
 
 // ---------------------------------
@@ -198,3 +310,40 @@ public:
   IR_HYBRID(Problem* _P) : IR(_P) { solver_name = SOLVER_NAME; }
   static void printHelp() { printHelpWithoutOption(SOLVER_NAME); }
 };
+
+// ---------------------------------
+// IR_ADAPTIVE
+// ---------------------------------
+/*
+ * Adaptive large neighborhood search.
+ * Refinement rules and sampling sizes of RANDOM are selected by roulette,
+ * weighted by recent improvement of sum-of-costs per millisecond.
+ */
+class IR_ADAPTIVE : public IR
+{
+public:
+  static const std::string SOLVER_NAME;
+private:
+  // weights of rules and sampling sizes
+  std::vector<double> weights;
+  std::vector<int> sampling_sizes;
+  std::vector<double> weights_sampling;
+
+  // initial weight, optimistic so that each rule is tried in early phase
+  static constexpr double INIT_WEIGHT = 1.0;
+  // how fast weights follow recent rewards
+  static constexpr double REACTION = 0.2;
+  // probability of selecting uniformly at random
+  static constexpr double EXPLORATION = 0.1;
+
+  void refinePlan();
+public:
+  // return index
+  static int selectByRoulette(const std::vector<double>& _weights,
+                              std::mt19937* const MT);
+  // reward = improvement / elapsed
+  static void updateWeight(double& weight, const double reward);
+
+  IR_ADAPTIVE(Problem* _P) : IR(_P) { solver_name = SOLVER_NAME; }
+  static void printHelp() { printHelpWithoutOption(SOLVER_NAME); }
+};
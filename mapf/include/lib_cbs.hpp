@@ -5,6 +5,7 @@
 #pragma once
 #include <memory>
 
+#include "reservation_table.hpp"
 #include "solver.hpp"
 
 namespace LibCBS
@@ -81,9 +82,6 @@ namespace LibCBS
     MDDNodes GC;                 // for memory management
     Solver* solver;              // solver
 
-    // cache, MDD without any constraints
-    static std::unordered_map<std::string, MDD_p> PURE_MDD_TABLE;
-
     MDD(int _c, int _i, Solver* _solver, Constraints constraints = {}, int time_limit = -1);
     ~MDD();
 
@@ -99,6 +97,10 @@ namespace LibCBS
     // update MDD with new constraints
     void update(const Constraints& _constraints);
 
+    // update MDD to avoid collisions with reserved paths
+    void update(const ReservationTable& table,
+                const std::vector<int>& ignored = {});
+
     // return whether MDD is updated or not
     bool forceUpdate(const Constraints& _constraints);
 
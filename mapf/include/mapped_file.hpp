@@ -0,0 +1,28 @@
+/*
+ * Read-only memory-mapped file for parsing instances and scenarios
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+class MappedFile
+{
+private:
+  const char* buf;
+  size_t buf_size;
+  bool opened;
+
+public:
+  MappedFile(const std::string& file_name);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool isOpen() const { return opened; }  // empty files are also opened
+  const char* data() const { return buf; }
+  size_t size() const { return buf_size; }
+};
+
+// whole [s, e) is a non-negative integer, e.g., "agents=(\d+)"
+bool parseUInt(const char* s, const char* e, int& v);
@@ -16,7 +16,7 @@ class PIBT : public Solver
 public:
   static const std::string SOLVER_NAME;
 
-private:
+protected:
   // PIBT agent
   struct Agent {
     int id;
@@ -37,20 +37,44 @@ private:
   // option
   bool disable_dist_init = false;
 
+  // for the step-level API, allocated in initSteps
+  std::vector<Agent> agents;
+  Agents order;         // agents in descending order of priorities
+  Agents order_buf;     // buffer to update the order
+  Agents order_static;  // by init_d and tie-breaker, used for agents at goals
+  Nodes C;              // candidates in chooseNode
+
   // result of priority inheritance: true -> valid, false -> invalid
   bool funcPIBT(Agent* ai);
   // plan next node
   Node* planOneStep(Agent* a);
   // chose one node from candidates, used in planOneStep
   Node* chooseNode(Agent* a);
+  // distance from v to the goal of a, used in chooseNode
+  virtual int goalDist(Agent* a, Node* v) { return pathDist(a->id, v); }
+  // decide next locations of all agents in the order, used in step
+  virtual void planNextLocations();
+  // after moving to v_next, used in step; reset at goals
+  virtual void updatePriority(Agent* a)
+  {
+    a->elapsed = (a->v_next == a->g) ? 0 : a->elapsed + 1;
+  }
 
   // main
+private:
   void run();
 
 public:
   PIBT(Problem* _P);
   ~PIBT() {}
 
+  // step-level API, e.g., for real-time control loops
+  // call initSteps once, then steps do not allocate memory
+  void initSteps();  // agents are at starts of the problem
+  // config: current locations, next: planned locations, sized by num agents
+  void step(const Config& config, Config& next);
+  Config step(const Config& config);
+
   void setParams(int argc, char* argv[]);
   static void printHelp();
 };
@@ -3,6 +3,10 @@
  */
 
 #pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "solver.hpp"
 
 class PIBT_COMPLETE : public Solver
@@ -15,6 +19,19 @@ private:
   enum struct COMP_SOLVER_TYPE { PUSH_AND_SWAP, ICBS, ECBS };
   COMP_SOLVER_TYPE comp_solver_type;
   std::vector<std::string> option_comp_solver;
+  // several comp-solvers -> race, they run concurrently by threads,
+  // the first success is used and the others are interrupted
+  std::vector<COMP_SOLVER_TYPE> comp_solver_types;
+  std::string comp_solver_name;  // solver used to complement, for log
+
+  std::shared_ptr<Solver> getCompSolver(Problem* const _Q,
+                                        const COMP_SOLVER_TYPE solver_type);
+  static bool getCompSolverType(const std::string& s, COMP_SOLVER_TYPE& type);
+  // solve the remain by one comp-solver, return: success?
+  bool complement(const Config& config_start, const int max_timestep_comp);
+  // solve the remain by the race of comp-solvers, return: success?
+  bool complementByRace(const Config& config_start,
+                        const int max_timestep_comp);
 
 public:
   static const std::string SOLVER_NAME;
@@ -25,7 +42,7 @@ public:
   PIBT_COMPLETE(Problem* _P);
   ~PIBT_COMPLETE() {}
 
-  void makeLog(const std::string& logfile);
+  void writeLog(std::ostream& log);
   void setParams(int argc, char* argv[]);
   static void printHelp();
 };
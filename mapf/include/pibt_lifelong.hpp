@@ -0,0 +1,82 @@
+/*
+ * Lifelong (online) variant of PIBT
+ *
+ * An agent receives a new goal as soon as it reaches the current one.
+ * New goals are read one by one from a task stream (file, fifo or stdin),
+ * or drawn randomly when no stream is given.
+ * The run continues until the stream is exhausted and all agents reach
+ * their last goals, or until the horizon; without the horizon, until the
+ * time limit. Only the latest configurations are kept in the solution.
+ */
+
+#pragma once
+#include <fstream>
+
+#include "pibt.hpp"
+
+class PIBT_LIFELONG : public PIBT
+{
+public:
+  static const std::string SOLVER_NAME;
+  static constexpr int DEFAULT_WINDOW = 1000;
+
+private:
+  // task stream, one goal "x,y" per line, "-" -> stdin
+  std::string task_file;
+  std::ifstream task_ifs;
+  std::istream* tasks;
+  bool tasks_exhausted;
+  std::vector<bool> idle;  // agents without tasks
+
+  // options
+  int horizon;  // timesteps, 0 -> unlimited, -1 -> max_timestep
+  int window;   // configurations kept, -1 -> all within the horizon
+
+  // connected component of each node, for random goals
+  std::vector<int> components;
+  std::vector<int> component_sizes;
+
+  // BFS from goals, evaluated lazily and resumed in later queries,
+  // distance_table[i] keeps the distances of the visited nodes, NIL otherwise
+  static constexpr int NIL = -1;
+  std::vector<std::vector<Node*>> bfs_visited;  // in order of distances
+  std::vector<int> bfs_head;                    // next node to expand
+
+  // latest configurations, ring buffer
+  Configs history;
+  int timestep;
+
+  // statistics
+  int tasks_completed;
+  double step_time_sum;  // micro sec
+  double step_time_max;  // micro sec
+
+  // next goal of a, nullptr -> no more tasks
+  Node* getNextTask(Agent* a);
+  // set new goal and reset BFS of the agent
+  void assignGoal(Agent* a, Node* g);
+  // distance from v to the current goal by lazy BFS
+  int goalDist(Agent* a, Node* v);
+  // priorities are kept on arrivals, as if the next goal was given
+  void updatePriority(Agent* a);
+  int lazyDist(const int i, Node* const v);
+  void createComponents();
+
+  // distances are computed during the run
+  void exec();
+  void run();
+
+public:
+  PIBT_LIFELONG(Problem* _P);
+  ~PIBT_LIFELONG() {}
+
+  int getTasksCompleted() const { return tasks_completed; }
+  int getTimesteps() const { return timestep; }
+  double getThroughput() const;  // tasks per timestep
+
+  // goals are changed, check only collisions and moves within the window
+  bool validateSolution();
+  void writeLog(std::ostream& log);
+  void setParams(int argc, char* argv[]);
+  static void printHelp();
+};
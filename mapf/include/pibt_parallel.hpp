@@ -0,0 +1,70 @@
+/*
+ * Spatially partitioned parallel PIBT
+ *
+ * The map is divided into vertical strips (regions).
+ * Agents are taken in the order of priorities.
+ * - Consecutive agents whose neighbors are all in the same region start
+ *   priority inheritance concurrently, one thread per region.
+ *   The inheritance is closed in the region, i.e., nodes of other regions
+ *   are not used.
+ * - Agents at the boundaries are planned sequentially by the original PIBT.
+ * Each region has its own random generator, so the plan depends on the
+ * number of regions but not on the number of threads.
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "pibt.hpp"
+
+class PIBT_PARALLEL : public PIBT
+{
+public:
+  static const std::string SOLVER_NAME;
+
+private:
+  struct Region {
+    Agents roots;     // agents starting inheritance, in the order
+    Nodes C;          // candidates in chooseNode
+    std::mt19937 MT;  // random generator of the region
+  };
+  std::vector<Region> regions;
+  std::vector<int> region_ids;    // node-id -> region
+  std::vector<bool> interior;     // node-id -> all neighbors in the region
+
+  // options
+  int regions_num;
+  int threads_num;
+
+  // workers, the main thread also plans regions
+  std::vector<std::thread> workers;
+  std::mutex mtx;
+  std::condition_variable cv_start;
+  std::condition_variable cv_done;
+  int generation;  // incremented in each timestep
+  int done_num;    // workers finishing the current timestep
+  bool terminated;
+  std::atomic<int> next_region;
+
+  void setupRegions();
+  void work();         // loop of workers
+  void planRegions();  // plan regions until no region remains
+  void planRegionsConcurrently();  // plan and clear roots of all regions
+
+  // PIBT closed in region k
+  bool funcPIBT(Agent* ai, const int k);
+  Node* planOneStep(Agent* a, const int k);
+  Node* chooseNode(Agent* a, const int k);
+
+  void planNextLocations();
+
+public:
+  PIBT_PARALLEL(Problem* _P);
+  ~PIBT_PARALLEL();
+
+  void setParams(int argc, char* argv[]);
+  static void printHelp();
+};
@@ -9,9 +9,11 @@ struct Plan {
 private:
   Configs configs;  // main
 
-public:
-  ~Plan() {}
+  // updated on every addition, path costs are queried frequently
+  std::vector<int> costs;  // path cost of each agent
+  int soc = 0;             // sum of costs
 
+public:
   // timestep -> configuration
   Config get(const int t) const;
 
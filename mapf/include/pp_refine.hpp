@@ -0,0 +1,52 @@
+/*
+ * Implementation of Prioritized Planning for Iterative Refinement
+ * This cannot be used directly
+ *
+ * Agents are planned one by one in a random order
+ * while avoiding paths in the reservation.
+ * Only solutions with smaller sum-of-costs are accepted.
+ */
+
+#pragma once
+#include "reservation_table.hpp"
+#include "solver.hpp"
+
+class PP_REFINE : public Solver
+{
+public:
+  static const std::string SOLVER_NAME;
+
+private:
+  const int ub_soc;  // sum of costs in the old plan
+
+  // reservation of agents outside of the problem
+  const ReservationTable* const reserved_p;
+  const std::vector<int> reserved_ignored;  // agents to be ignored, sorted
+
+  std::vector<bool> table_goals;  // whether goals of agents in the problem
+
+  // number of random orders to try
+  int max_trials;
+  static constexpr int DEFAULT_MAX_TRIALS = 10;
+
+  // plan all agents in the order, soc_limit: upper bound of sum-of-costs
+  // failed -> return empty paths
+  Paths getPathsByOrder(const std::vector<int>& order, const int soc_limit);
+
+  // single-agent path avoiding reserved and planned paths
+  Path getPath(const int id, const ReservationTable& planned,
+               const int cost_limit);
+
+  void run();
+
+public:
+  // all agents in _P are replanned
+  // _ignored: sorted ids of agents in _P within the reservation
+  PP_REFINE(Problem* _P, const Plan& _old_plan,
+            const ReservationTable* _reserved_p,
+            const std::vector<int>& _ignored);
+  ~PP_REFINE() {}
+
+  void setParams(int argc, char* argv[]);
+  static void printHelp();
+};
@@ -1,12 +1,17 @@
 #pragma once
+#include <memory>
 #include <random>
+#include <unordered_map>
 #include <graph.hpp>
 
+#include "cancel_token.hpp"
 #include "default_params.hpp"
 #include "util.hpp"
 
 using Config = std::vector<Node*>;  // < loc_0[t], loc_1[t], ... >
 using Configs = std::vector<Config>;
+// parsed graphs, key: map file
+using GraphTable = std::unordered_map<std::string, std::unique_ptr<Graph>>;
 
 // check two configurations are same or not
 [[maybe_unused]] static bool sameConfig(const Config& config_i,
@@ -31,6 +36,8 @@ using Configs = std::vector<Config>;
   return cost;
 }
 
+class Scenario;
+
 class Problem
 {
 private:
@@ -43,7 +50,11 @@ private:
   int max_timestep;      // timestep limit
   int max_comp_time;     // comp_time limit, ms
 
+  // shared with derived problems, solvers use child tokens
+  std::shared_ptr<CancelToken> cancel_token;
+
   const bool instance_initialized;  // for memory manage
+  const bool graph_shared;          // G is owned by a graph table
 
   // set starts and goals randomly
   void setRandomStartsGoals();
@@ -57,6 +68,19 @@ private:
 
 public:
   Problem(const std::string& _instance);
+  // graphs are looked up in, or added to, _graphs and not owned by the problem
+  // note: graph caches are not thread-safe, use one table per thread
+  Problem(const std::string& _instance, GraphTable* _graphs);
+  // first _num_agents entries of a parsed MovingAI scenario
+  // the graph is shared when _graphs is given, as above
+  Problem(const Scenario& scen, int _num_agents, GraphTable* _graphs = nullptr,
+          int _max_comp_time = DEFAULT_MAX_COMP_TIME,
+          int _max_timestep = DEFAULT_MAX_TIMESTEP, int _seed = DEFAULT_SEED);
+  // starts and goals on a given graph, e.g., requests of the daemon
+  // the graph is not owned by the problem
+  Problem(Graph* _G, const Config& _config_s, const Config& _config_g,
+          int _max_comp_time, int _max_timestep, int _seed = DEFAULT_SEED);
+  // the number of agents follows _config_s, e.g., sub-problems
   Problem(Problem* P, Config _config_s, Config _config_g, int _max_comp_time,
           int _max_timestep);
   Problem(Problem* P, int _max_comp_time);
@@ -74,9 +98,23 @@ public:
   std::string getInstanceFileName() { return instance; };
 
   void setMaxCompTime(const int t) { max_comp_time = t; }
+  void setMT(std::mt19937* const _MT) { MT = _MT; }  // e.g., for threads
+
+  // stop solvers of this problem and derived ones, thread-safe
+  void interrupt() { cancel_token->cancel(); }
+  bool isInterrupted() const { return cancel_token->isCancelled(); }
+  // e.g., token of the parent solver, or to stop a group of solvers together
+  std::shared_ptr<CancelToken> getCancelToken() const { return cancel_token; }
+  void setCancelToken(std::shared_ptr<CancelToken> token)
+  {
+    cancel_token = token;
+  }
 
   bool isInitializedInstance() const { return instance_initialized; }
 
+  // graph of the map file in the table, parsed and registered if not found
+  static Graph* getGraph(const std::string& map_file, GraphTable* graphs);
+
   // used when making new instance file
   void makeScenFile(const std::string& output_file);
 };
@@ -15,69 +15,89 @@ class PushAndSwap : public Solver
 public:
   static const std::string SOLVER_NAME;
 
-private:
+protected:
   bool flg_compress;          // whether to compress solution
   bool disable_dist_init;     // prioritization depending on distance
-  Nodes nodes_with_many_neighbors;  // nodes of degree >= 3
 
   // used in occupancy
   static constexpr int NIL = -1;
 
+  // single-agent move, one timestep of the plan
+  struct Move {
+    int id;      // agent
+    Node* from;  // location before the move
+    Node* to;    // location after the move
+  };
+  // plans are kept as event logs,
+  // configurations are created only at compression or output
+  std::vector<Move> moves;
+  Config config_now;              // locations after all moves
+  std::vector<int> occupied_now;  // node-id -> agent
+
   // main
   void run();
 
   // push operation
-  bool push(Plan& plan, const int i, Nodes& U, std::vector<int>& occupied_now);
+  bool push(const int i, Nodes& U);
 
   // swap operation
-  bool swap(Plan& plan, const int i, Nodes& U, std::vector<int>& occupied_now);
+  bool swap(const int i, Nodes& U);
 
   // improve solution quality, see
-  Plan compress(const Plan& plan);
+  Plan compress() const;
+
+  // create configurations from the event log
+  Plan getPlan() const;
 
   // ---------------------------------------
   // sub procedures
 
   // push several agents simultaneously
-  bool multiPush(Plan& plan, const int r, const int s, const Path& p,
-                 std::vector<int>& occupied_now);
+  bool multiPush(const int r, const int s, const Path& p);
 
   // clear operation
-  bool clear(Plan& plan, Node* v, const int r, const int s,
-             std::vector<int>& occupied_now);
+  bool clear(Node* v, const int r, const int s);
+
+  // move r and s to the swap vertex v and clear its neighbors,
+  // moves are canceled when failed
+  bool trySwapVertex(Node* v, const int r, const int s);
 
   // execute swap operation
-  void executeSwap(Plan& plan, const int r, const int s,
-                   std::vector<int>& occupied_now);
+  void executeSwap(const int r, const int s);
 
   // resolve operation
-  bool resolve(Plan& plan, const int r, const int s, Nodes& U,
-               std::vector<int>& occupied_now);
+  bool resolve(const int r, const int s, Nodes& U);
 
 
   // ---------------------------------------
   // utilities
 
   // get nearest empty location
-  Node* getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
-                            const Nodes& obs);
+  Node* getNearestEmptyNode(Node* v, const Nodes& obs);
 
   // get the shortest path towards goals
-  Path getShortestPath(const int id, Node* s, std::vector<int>& occupied_now);
+  Path getShortestPath(const int id, Node* s);
 
   // push toward empty node
-  bool pushTowardEmptyNode(Node* v, Plan& plan, std::vector<int>& occupied_now,
-                           const Nodes& obs);
+  bool pushTowardEmptyNode(Node* v, const Nodes& obs);
 
   // update plan
-  void updatePlan(const int id, Node* next_node, Plan& plan,
-                  std::vector<int>& occupied_now);
+  void updatePlan(const int id, Node* next_node);
+
+  // cancel moves until the log has the given size
+  void undoMoves(const int size);
 
-  // get all vertices of degree >= 3 on G
-  void findNodesWithManyNeighbors();
+  // swap vertices, i.e., nodes of degree >= 3, in order of path distance,
+  // enumerated lazily by breadth-first search
+  std::vector<int> bfs_parents;  // node-id -> parent node-id
+  std::vector<int> bfs_queue;    // visited node-ids
+  int bfs_head;                  // next node to expand
+  void initSwapVertexSearch(Node* root);
+  Node* getNextSwapVertex();  // nullptr -> no more
+  Path getPathToSwapVertex(Node* v) const;
 
   // error check
-  void checkConsistency(Plan& plan, std::vector<int>& occupied_now);
+  void checkConsistency();
 
 public:
   PushAndSwap(Problem* _P);
@@ -0,0 +1,61 @@
+#pragma once
+#include <unordered_map>
+
+#include "plan.hpp"
+
+/*
+ * space-time reservation of fixed paths
+ * collision checks against the reserved paths take O(1)
+ */
+
+struct ReservationTable {
+private:
+  // [t]: node-id -> agent, locations before agents reach their goals
+  std::vector<std::unordered_map<int, int>> body;
+  // node-id -> (agent, timestep), agents staying at their goals from the timestep
+  std::unordered_map<int, std::tuple<int, int>> goals;
+
+public:
+  static constexpr int NIL = -1;
+
+  ReservationTable() {}
+  ReservationTable(const Plan& plan, const std::vector<int>& agents);
+  ~ReservationTable() {}
+
+  // register a path of a_i, the agent stays at the last node afterward
+  void add(const int i, const Path& path);
+
+  // remove a path of a_i
+  void remove(const int i, const Path& path);
+
+  // become empty
+  void clear();
+
+  // whether nothing is reserved
+  bool empty() const;
+
+  /*
+   * Queries below accept a sorted list of agents to be ignored,
+   * e.g., agents being replanned in a sub-problem.
+   */
+
+  // timestep, location -> agent, NIL -> no one reserves
+  int get(const int t, Node* const v,
+          const std::vector<int>& ignored = {}) const;
+
+  // whether the move u -> v at t collides with reserved paths
+  bool isConflicted(Node* const u, Node* const v, const int t,
+                    const std::vector<int>& ignored = {}) const;
+
+  // whether a path collides with reserved paths
+  bool isConflicted(const Path& path,
+                    const std::vector<int>& ignored = {}) const;
+
+  // last timestep when an agent passes v, NIL -> never
+  // note: agents staying at v forever are not considered
+  int getLastReservedTime(Node* const v,
+                          const std::vector<int>& ignored = {}) const;
+
+  // last timestep of reserved moves
+  int getMakespan() const;
+};
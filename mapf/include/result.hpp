@@ -0,0 +1,98 @@
+/*
+ * Compact binary result format
+ *
+ * Layout, integers are LEB128 varints:
+ *   "MAPF", version (1 byte), flags (1 byte, bit 0: deflate)
+ *   then the body, compressed by deflate when the flag is set:
+ *     width of the grid, number of agents
+ *     node ids of starts, node ids of goals
+ *     timesteps, each one is (number of moved agents + 1), followed by
+ *     pairs of (agent id gap, zigzag delta of the node id),
+ *     delta from the starts at timestep zero
+ *     0 as the end of timesteps
+ *     length and text of the other lines of the log, i.e., key=value
+ *
+ * Results are written by the streaming writer and read by the reader,
+ * which also converts them back to the text format for the visualizer.
+ * Compression requires zlib, see MAPF_USE_ZLIB.
+ */
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "problem.hpp"
+
+#ifdef MAPF_USE_ZLIB
+#include <zlib.h>
+#endif
+
+class ResultWriter
+{
+private:
+  static constexpr int BUFFER_SIZE = 1 << 16;  // bytes kept before writing
+
+  const std::string file_name;
+  std::ofstream file;
+  bool compressed;
+  std::string buf;            // encoded bytes not written yet
+  std::vector<int> last_ids;  // node ids of the last configuration
+  bool config_started;        // starts and goals are written
+#ifdef MAPF_USE_ZLIB
+  z_stream zs;
+#endif
+
+  void putVarint(uint64_t x);
+  void putSignedVarint(int64_t x);
+  void flush(const bool finish = false);  // encode and write buf
+  void halt(const std::string& msg) const;
+
+public:
+  // compressed is ignored without zlib
+  ResultWriter(const std::string& _file_name, const bool _compressed = false);
+  ~ResultWriter();
+
+  void writeStartsGoals(const int width, const Config& starts,
+                        const Config& goals);
+  void addConfig(const Config& config);  // in order of timesteps
+  // write the other lines of the log and close the file
+  void close(const std::string& info = "");
+
+  // result file names, ".bin" -> binary, ".binz" -> compressed binary
+  static bool isBinaryFile(const std::string& file_name);
+  static bool isCompressedFile(const std::string& file_name);
+};
+
+class ResultReader
+{
+private:
+  std::string body;  // decoded body
+  size_t pos;        // read position in body
+
+  int width;
+  std::vector<int> starts;  // node ids
+  std::vector<int> goals;
+  std::vector<std::vector<int>> configs;  // [timestep][agent], node ids
+  std::string info;                       // other lines of the log
+
+  uint64_t getVarint();
+  int64_t getSignedVarint();
+  void halt(const std::string& msg) const;
+
+public:
+  ResultReader(const std::string& file_name);
+
+  int getWidth() const { return width; }
+  int getNum() const { return starts.size(); }
+  int getMakespan() const { return (int)configs.size() - 1; }
+  const std::vector<int>& getStarts() const { return starts; }
+  const std::vector<int>& getGoals() const { return goals; }
+  const std::vector<int>& getConfig(const int t) const { return configs[t]; }
+  const std::string& getInfo() const { return info; }
+
+  // same as the text result of Solver::makeLog
+  void writeText(std::ostream& log) const;
+  void writeText(const std::string& file_name) const;
+};
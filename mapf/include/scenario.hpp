@@ -0,0 +1,51 @@
+/*
+ * MovingAI scenario, https://movingai.com/benchmarks/formats.html
+ *
+ *   version 1
+ *   [bucket] [map] [width] [height] [x_s] [y_s] [x_g] [y_g] [optimal length]
+ *
+ * Columns are separated by tabs or spaces.
+ * A scenario is parsed once, then problems of any number of agents take
+ * its first entries, e.g., sweeping the number of agents in batch mode.
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+class Scenario
+{
+public:
+  struct Entry {
+    int bucket;
+    int x_s;
+    int y_s;
+    int x_g;
+    int y_g;
+    double optimal_length;
+  };
+
+private:
+  const std::string file_name;
+  std::string map_file;  // without directories, found in map/
+  int width;
+  int height;
+  std::vector<Entry> entries;
+
+  void halt(const std::string& msg) const;
+
+public:
+  Scenario(const std::string& _file_name);
+
+  const std::string& getFileName() const { return file_name; }
+  const std::string& getMapFileName() const { return map_file; }
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  int getSize() const { return entries.size(); }
+  const Entry& getEntry(const int i) const { return entries[i]; }
+
+  // ".scen" -> scenario, otherwise the instance format
+  static bool isScenFile(const std::string& file_name);
+};
@@ -0,0 +1,56 @@
+/*
+ * Append-only stream of anytime solutions, e.g., improvements of IR
+ *
+ * The file starts with the lines given as the header, then records follow.
+ * Each record is
+ *   iter=[INT],comp_time=[INT],soc=[INT],makespan=[INT],agents=[INT]
+ *   [AGENT_ID]:(x,y),(x,y),...
+ * where only the agents whose paths changed are listed.
+ * Paths end when the agents reach their goals for the last time,
+ * the first record contains all agents.
+ * The file ends with "end" when the stream is closed.
+ *
+ * Records are formatted and written by a background thread,
+ * so that the solver never waits for the disk.
+ */
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "problem.hpp"
+
+class SolutionStream
+{
+public:
+  struct Record {
+    int iteration;
+    int comp_time;
+    int soc;
+    int makespan;
+    std::vector<std::tuple<int, Path>> paths;  // changed agents
+  };
+
+private:
+  const std::string file_name;
+  std::ofstream file;
+
+  std::thread worker;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::deque<Record> queue;  // guarded by mtx
+  bool closed;               // guarded by mtx
+
+  void work();  // loop of the worker
+  void write(const Record& record);
+
+public:
+  SolutionStream(const std::string& _file_name, const std::string& header);
+  ~SolutionStream();
+
+  void push(Record&& record);  // never blocks on the disk
+  void close();                // write the rest and "end", then join
+};
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <unordered_map>
 #include <functional>
@@ -13,17 +14,27 @@
 #include "problem.hpp"
 #include "util.hpp"
 
+namespace LibCBS
+{
+struct MDD;
+}
+class ResultWriter;
+
 class MinimumSolver
 {
 protected:
   std::string solver_name;       // solver name
   Problem* const P;              // problem instance
   Graph* const G;                // graph
-  std::mt19937* const MT;        // seed for randomness
+  std::shared_ptr<std::mt19937> rng;  // random stream of this solver
+  std::mt19937* const MT;        // seed for randomness, refers to rng
   const int max_timestep;        // maximum makespan
   const int max_comp_time;       // time limit for computation, ms
   Plan solution;                 // solution
   bool solved;                   // success -> true, failed -> false (default)
+  // stopped by the time limit, the parents or from outside,
+  // nested solvers should use it or its children
+  std::shared_ptr<CancelToken> token;
 
 private:
   int comp_time;             // computation time
@@ -44,10 +55,13 @@ public:
   // getter
   Plan getSolution() const { return solution; };
   bool succeed() const { return solved; };
+  // check the solution, e.g., goals are changed in lifelong settings
+  virtual bool validateSolution() { return solution.validate(P); }
   std::string getSolverName() const { return solver_name; };
   int getMaxTimestep() const { return max_timestep; };
   int getCompTime() const { return comp_time; }
   int getSolverElapsedTime() const;  // get elapsed time from start
+  std::shared_ptr<CancelToken> getCancelToken() const { return token; }
 };
 
 // -----------------------------------------------
@@ -66,7 +80,21 @@ protected:
   using DistanceTable = std::vector<std::vector<int>>;  // [agent][node_id]
   DistanceTable distance_table;     // distance table
   DistanceTable* distance_table_p;  // pointer, used in nested solvers
+  std::vector<int> distance_table_ids;  // agent -> row of *distance_table_p
 
+  // rows of the distance table kept between problems, e.g., in the daemon
+  // valid for one graph and max_timestep
+public:
+  using DistanceCache = std::unordered_map<int, std::vector<int>>;  // [goal_id]
+protected:
+  DistanceCache* distance_cache_p;
+
+  // cache of MDDs without constraints, see LibCBS::MDD
+public:
+  using MDDTable = std::unordered_map<std::string, std::shared_ptr<LibCBS::MDD>>;
+protected:
+  MDDTable mdd_table;
+  MDDTable* mdd_table_p;  // pointer, used in nested solvers
 
   // -------------------------------
   // main
@@ -106,22 +134,29 @@ protected:
     std::cout << head << " ";
     info(std::forward<Tail>(tail)...);
   }
-  void halt(const std::string& msg) const;  // halt program
+  void halt(const std::string& msg) const;  // throw MAPFError
   void warn(const std::string& msg) const;  // just printing msg
 
   // -------------------------------
   // log
 public:
-  virtual void makeLog(const std::string& logfile = "./result.txt");
+  // ".bin" or ".binz" -> binary, see result.hpp
+  void makeLog(const std::string& logfile = "./result.txt");
+  virtual void writeLog(std::ostream& log);  // content of the log
 protected:
-  void makeLogBasicInfo(std::ofstream& log);
-  void makeLogSolution(std::ofstream& log);
+  void makeLogBasicInfo(std::ostream& log);
+  void makeLogSolution(std::ostream& log);
+private:
+  // not nullptr -> makeLogSolution streams the solution to the binary result
+  ResultWriter* result_writer;
 
   // -------------------------------
   // utilities for solver options
 public:
   virtual void setParams(int argc, char* argv[]){};
   void setVerbose(bool _verbose) { verbose = _verbose; }
+  // getopt is not thread-safe, hold this while calling setParams
+  static std::mutex option_mtx;
 protected:
   // used for set underlying solver options
   static void setSolverOption(std::shared_ptr<Solver> solver,
@@ -141,9 +176,22 @@ public:
   int pathDist(const int i) const;                 // get path distance between s_i -> g_i
   void createDistanceTable();                      // compute distance table
   void setDistanceTable(DistanceTable* p) { distance_table_p = p; }  // used in nested solvers
+  // used in sub-problems, a_i refers to the row ids[i]
+  void setDistanceTable(DistanceTable* p, const std::vector<int>& ids);
+  void setDistanceCache(DistanceCache* p) { distance_cache_p = p; }
+protected:
+  std::vector<int> createDistanceRow(Node* const g) const;  // BFS from g
+public:
   // use grid-pathfinding
   int pathDist(Node* const s, Node* const g) const { return G->pathDist(s, g); }
 
+  // -------------------------------
+  // utilities for MDD
+public:
+  MDDTable* getMDDTable() { return mdd_table_p != nullptr ? mdd_table_p : &mdd_table; }
+  // used in nested solvers, not shared between threads
+  void setMDDTable(MDDTable* p) { mdd_table_p = p; }
+
 
   // -------------------------------
   // utilities for getting path
@@ -177,14 +225,15 @@ public:
   static Path getPathBySpaceTimeAstar
   (Node* const s,                                 // start
    Node* const g,                                 // goal
-   AstarHeuristics& fValue,                       // func: f-value
-   CompareAstarNode& compare,                     // func: compare two nodes
-   CheckAstarFin& checkAstarFin,                  // func: check goal
-   CheckInvalidAstarNode& checkInvalidAstarNode,  // func: check invalid nodes
-   const int time_limit=-1                        // time limit
+   const AstarHeuristics& fValue,                       // func: f-value
+   const CompareAstarNode& compare,                     // func: compare two nodes
+   const CheckAstarFin& checkAstarFin,                  // func: check goal
+   const CheckInvalidAstarNode& checkInvalidAstarNode,  // func: check invalid nodes
+   const int time_limit=-1,                       // time limit
+   const CancelToken* const token=nullptr         // cancellation
    );
   // typical functions
-  static CompareAstarNode compareAstarNodeBasic;
+  static const CompareAstarNode compareAstarNodeBasic;
   // prioritized planning
   Path getPrioritizedPath(
       const int id,                // agent id
@@ -193,7 +242,7 @@ public:
       const int upper_bound = -1,  // upper bound of timesteps
       const std::vector<std::tuple<Node*, int>>& constraints =
           {},  // additional constraints, space-time
-      CompareAstarNode& compare = compareAstarNodeBasic,  // compare two nodes
+      const CompareAstarNode& compare = compareAstarNodeBasic,  // compare two nodes
       const bool manage_path_table =
           true  // manage path table automatically, conflict check
   );
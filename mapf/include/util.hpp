@@ -7,10 +7,19 @@
 #include <chrono>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 
 // for computation time
 using Time = std::chrono::steady_clock;
 
+// thrown by halt(), the process is not terminated
+// so that other solvers in the same process can continue
+class MAPFError : public std::runtime_error
+{
+public:
+  using std::runtime_error::runtime_error;
+};
+
 // whether element 'a' is found in vector T
 template <typename T>
 static bool inArray(const T a, const std::vector<T>& arr)
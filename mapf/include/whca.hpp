@@ -23,6 +23,24 @@ private:
 
   // option
   bool disable_dist_init = false;
+  // keep paths of agents staying at their goals in the next window,
+  // agents on the way are replanned in every window as usual
+  bool reuse = false;
+
+  // paths of the current window, registered in PATH_TABLE
+  Paths partial_paths;
+  // time of arriving at the last node of the partial path
+  std::vector<int> arrivals;
+  // number of partial paths planned for each agent
+  std::vector<int> planned_nums;
+
+  // plan one window from config, return false when failed
+  // with reuse_paths, also fails when a kept path next to the start of
+  // a stuck agent blocks it
+  bool planWindow(const std::vector<int>& ids, const Config& config,
+                  const bool reuse_paths);
+  // remove a partial path from PATH_TABLE
+  void clearPath(const int id);
 
   Path getPrioritizedPartialPath(int id, Node* s, Node* g, const Paths& paths);
 
@@ -35,6 +53,9 @@ public:
   WHCA(Problem* _P);
   ~WHCA(){};
 
+  // for tests
+  int getPlannedNum(const int i) const { return planned_nums[i]; }
+
   void setParams(int argc, char* argv[]);
   static void printHelp();
 };
@@ -23,10 +23,29 @@ private:
   std::vector<int> occupied_t;  // node-id -> timestep
   std::vector<int> occupied_a;  // node-id -> agent
 
+  // used for tie-break
+  std::vector<bool> table_goals;
+
+  // reusable context of space-time A* in getSinglePath
+  struct SearchNode {
+    Node* v;  // location
+    int g;    // time
+    int f;    // f-value
+    int p;    // parent, index of search_nodes
+  };
+  std::vector<SearchNode> search_nodes;     // pool, cleared in each search
+  std::vector<int> open_list;               // binary heap of search_nodes
+  std::vector<std::vector<int>> closed_id;  // time -> node-id -> search id
+  int search_id;                            // stamp of the current search
+  Nodes C;                                  // candidates in chooseNode
+  Path path_buf;                            // results of getSinglePath
+  Path replan_buf;
+
   // main
   void run();
 
-  Path getSinglePath(const int id, std::vector<Path>& paths);
+  // write a path from the last location, empty -> failed
+  void getSinglePath(const int id, std::vector<Path>& paths, Path& path);
   bool funcPIBT(const int id, std::vector<Path>& paths,
                 Node* v_other_to = nullptr, Node* v_other_from = nullptr);
   Node* chooseNode(const int id, std::vector<Path>& paths,
@@ -0,0 +1,64 @@
+#include "../include/cancel_token.hpp"
+
+CancelToken::CancelToken()
+    : parent(nullptr), cancelled(false), deadline(Time::time_point::max())
+{
+}
+
+CancelToken::CancelToken(std::shared_ptr<CancelToken> _parent)
+    : CancelToken(_parent, Time::time_point::max())
+{
+}
+
+CancelToken::CancelToken(std::shared_ptr<CancelToken> _parent,
+                         const Time::time_point _deadline)
+    : parent(_parent),
+      cancelled(false),
+      deadline((_parent == nullptr) ? _deadline
+                                    : std::min(_deadline, _parent->deadline))
+{
+}
+
+bool CancelToken::isCancelled() const
+{
+  for (auto t = this; t != nullptr; t = t->parent.get()) {
+    if (t->cancelled) return true;
+  }
+  return false;
+}
+
+bool CancelToken::isExpired() const
+{
+  return isCancelled() || (hasDeadline() && Time::now() >= deadline);
+}
+
+bool CancelToken::isExpired(const Time::time_point now) const
+{
+  return isCancelled() || now >= deadline;
+}
+
+int CancelToken::getRemainedTime() const
+{
+  if (!hasDeadline()) return -1;
+  const auto t = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - Time::now());
+  return std::max(0, (int)t.count());
+}
+
+CancelPoller::CancelPoller(const CancelToken* const _token,
+                           const int time_limit)
+    : token(_token),
+      deadline((time_limit > 0)
+                   ? Time::now() + std::chrono::milliseconds(time_limit)
+                   : Time::time_point::max()),
+      count(0)
+{
+}
+
+bool CancelPoller::stop()
+{
+  if (++count < INTERVAL) return false;
+  count = 0;
+  const auto now = Time::now();
+  return now > deadline || (token != nullptr && token->isExpired(now));
+}
@@ -195,7 +195,7 @@ Path CBS::getConstrainedPath(HighLevelNode_p h_node, int id)
   };
 
   return getPathBySpaceTimeAstar
-    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, getRemainedTime());
+    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, -1, token.get());
 }
 
 void CBS::printHelp()
@@ -8,6 +8,7 @@ CBS_REFINE::CBS_REFINE(Problem* _P, const Plan& _old_plan,
       ub_makespan(_old_plan.getMakespan()),
       ub_soc(_old_plan.getSOC()),
       modif_list(_modif_list),
+      reserved_p(&reserved),
       makespan_prioritized(false)
 {
   // create fixed_agents set
@@ -17,7 +18,42 @@ CBS_REFINE::CBS_REFINE(Problem* _P, const Plan& _old_plan,
     for (int i = 0; i < size; ++i) {
       if (!inArray(i, modif_list)) fixed_agents.push_back(i);
     }
+    reserved = ReservationTable(_old_plan, fixed_agents);
   }
+
+  // goal table
+  table_goals.resize(G->getNodesSize(), false);
+  for (auto v : P->getConfigGoal()) table_goals[v->id] = true;
+}
+
+static std::vector<int> getAllAgents(Problem* P)
+{
+  std::vector<int> agents(P->getNum());
+  std::iota(agents.begin(), agents.end(), 0);
+  return agents;
+}
+
+CBS_REFINE::CBS_REFINE(Problem* _P, const Plan& _old_plan,
+                       const ReservationTable* _reserved_p,
+                       const std::vector<int>& _ignored)
+    : CBS_REFINE(_P, _old_plan, getAllAgents(_P))
+{
+  reserved_p = _reserved_p;
+  reserved_ignored = _ignored;
+}
+
+bool CBS_REFINE::isConflictedWithFixedAgents(AstarNode* m) const
+{
+  return reserved_p->isConflicted(m->p->v, m->v, m->g, reserved_ignored);
+}
+
+bool CBS_REFINE::isOthersGoal(const int id, Node* const v) const
+{
+  if (v == P->getGoal(id)) return false;
+  if (table_goals[v->id]) return true;
+  // agents outside of the problem stay at their goals after the makespan
+  return reserved_p->get(reserved_p->getMakespan() + 1, v,
+                         reserved_ignored) != ReservationTable::NIL;
 }
 
 void CBS_REFINE::setInitialHighLevelNode(HighLevelNode_p n)
@@ -50,17 +86,10 @@ Path CBS_REFINE::getInitialPath(int id)
 {
   Node* s = P->getStart(id);
   Node* g = P->getGoal(id);
-  Nodes config_g = P->getConfigGoal();
 
   // pre processing
-  int max_constraint_time = 0;
-  for (auto i : fixed_agents) {
-    for (int t = 1; t <= ub_makespan; ++t) {
-      if (old_paths.get(i, t) == g) {
-        max_constraint_time = std::max(max_constraint_time, t);
-      }
-    }
-  }
+  const int max_constraint_time =
+      std::max(0, reserved_p->getLastReservedTime(g, reserved_ignored));
 
   AstarHeuristics fValue;
   if (pathDist(id) > max_constraint_time) {
@@ -74,8 +103,8 @@ Path CBS_REFINE::getInitialPath(int id)
   CompareAstarNode compare = [&](AstarNode* a, AstarNode* b) {
     if (a->f != b->f) return a->f > b->f;
     // IMPORTANT! avoid goal locations of others
-    if (a->v != g && inArray(a->v, config_g)) return true;
-    if (b->v != g && inArray(b->v, config_g)) return false;
+    if (isOthersGoal(id, a->v)) return true;
+    if (isOthersGoal(id, b->v)) return false;
     if (a->g != b->g) return a->g < b->g;
     return false;
   };
@@ -88,23 +117,15 @@ Path CBS_REFINE::getInitialPath(int id)
     if (m->g > ub_makespan) {
       // cut off low-level nodes
       if (makespan_prioritized) return true;
-      if (inArray(m->v, config_g) && m->v != g) return true;
+      if (isOthersGoal(id, m->v)) return true;
       return false;
     }
     // see conflicts with fixed agents
-    for (auto i : fixed_agents) {
-      // vertex conflicts
-      if (m->v == old_paths.get(i, m->g)) return true;
-      // swap conflicts
-      if (m->v == old_paths.get(i, m->g - 1) &&
-          m->p->v == old_paths.get(i, m->g))
-        return true;
-    }
-    return false;
+    return isConflictedWithFixedAgents(m);
   };
 
   return getPathBySpaceTimeAstar
-    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, getRemainedTime());
+    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, -1, token.get());
 }
 
 CBS::CompareHighLevelNodes CBS_REFINE::getObjective()
@@ -140,13 +161,12 @@ Path CBS_REFINE::getConstrainedPath(HighLevelNode_p h_node, int id)
     return n->g + pathDist(id, n->v);
   };
 
-  Nodes config_g = P->getConfigGoal();
   CompareAstarNode compare = [&](AstarNode* a, AstarNode* b) {
     if (a->f != b->f) return a->f > b->f;
     if (a->g != b->g) return a->g < b->g;
     // avoid other's goal
-    if (a->v != g && inArray(a->v, config_g)) return true;
-    if (b->v != g && inArray(b->v, config_g)) return false;
+    if (isOthersGoal(id, a->v)) return true;
+    if (isOthersGoal(id, b->v)) return false;
     // avoid conflict with others
     for (int i = 0; i < P->getNum(); ++i) {
       if (i == id) continue;
@@ -177,20 +197,11 @@ Path CBS_REFINE::getConstrainedPath(HighLevelNode_p h_node, int id)
       }
     }
     // check collisions with fixed agents
-    for (auto i : fixed_agents) {
-      // vertex conflicts
-      if (m->v == old_paths.get(i, m->g)) return true;
-      // swap conflicts
-      if (m->v == old_paths.get(i, m->g - 1) &&
-          m->p->v == old_paths.get(i, m->g)) {
-        return true;
-      }
-    }
-    return false;
+    return isConflictedWithFixedAgents(m);
   };
 
   return getPathBySpaceTimeAstar
-    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, getRemainedTime());
+    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, -1, token.get());
 }
 
 void CBS_REFINE::setParams(int argc, char* argv[])
@@ -0,0 +1,167 @@
+#include "../include/ecbs_refine.hpp"
+
+const std::string ECBS_REFINE::SOLVER_NAME = "ECBS_REFINE";
+
+ECBS_REFINE::ECBS_REFINE(Problem* _P, const Plan& _old_plan,
+                         const ReservationTable* _reserved_p,
+                         const std::vector<int>& _ignored)
+    : ECBS(_P),
+      ub_soc(_old_plan.getSOC()),
+      reserved_p(_reserved_p),
+      reserved_ignored(_ignored)
+{
+  solver_name = SOLVER_NAME + "-" + std::to_string(sub_optimality);
+  table_goals.resize(G->getNodesSize(), false);
+  for (auto v : P->getConfigGoal()) table_goals[v->id] = true;
+}
+
+void ECBS_REFINE::run()
+{
+  ECBS::run();
+
+  // bounded-suboptimal solutions might be worse than the old plan
+  if (solved && solution.getSOC() > ub_soc) {
+    info(" ", "worse than the old plan, soc:", ub_soc, "->",
+         solution.getSOC());
+    solved = false;
+  }
+}
+
+bool ECBS_REFINE::isOthersGoal(const int id, Node* const v) const
+{
+  if (v == P->getGoal(id)) return false;
+  if (table_goals[v->id]) return true;
+  // agents outside of the problem stay at their goals after the makespan
+  return reserved_p->get(reserved_p->getMakespan() + 1, v,
+                         reserved_ignored) != ReservationTable::NIL;
+}
+
+void ECBS_REFINE::setInitialHighLevelNode(HighLevelNode_p n)
+{
+  // lower bounds are used for pruning in the low-level search
+  n->paths = Paths(P->getNum());
+  n->constraints = {};
+  n->f_mins.clear();
+  for (int i = 0; i < P->getNum(); ++i) n->f_mins.push_back(pathDist(i));
+  n->LB = std::accumulate(n->f_mins.begin(), n->f_mins.end(), 0);
+  n->valid = true;
+
+  // paths are planned one by one, avoiding conflicts in the focal search
+  for (int i = 0; i < P->getNum(); ++i) {
+    auto res = getFocalPath(n, i);
+    const Path path = std::get<0>(res);
+    if (path.empty()) {  // failed
+      n->valid = false;
+      return;
+    }
+    n->paths.insert(i, path);
+    n->LB = n->LB - n->f_mins[i] + std::get<1>(res);
+    n->f_mins[i] = std::get<1>(res);
+  }
+  n->makespan = n->paths.getMakespan();
+  n->soc = n->paths.getSOC();
+  n->f = n->paths.countConflict();
+}
+
+std::tuple<Path, int> ECBS_REFINE::getFocalPath(HighLevelNode_p h_node,
+                                                int id)
+{
+  Node* s = P->getStart(id);
+  Node* g = P->getGoal(id);
+
+  // pre processing
+  LibCBS::Constraints constraints;
+  int max_constraint_time =
+      std::max(0, reserved_p->getLastReservedTime(g, reserved_ignored));
+  for (auto c : h_node->constraints) {
+    if (c->id == id) {
+      constraints.push_back(c);
+      if (c->v == g && c->u == nullptr) {
+        max_constraint_time = std::max(max_constraint_time, c->t);
+      }
+    }
+  }
+
+  // f-value for online list
+  FocalHeuristics f1Value;
+  if (pathDist(id) > max_constraint_time) {
+    f1Value = [&](FocalNode* n) { return n->g + pathDist(id, n->v); };
+  } else {
+    f1Value = [&](FocalNode* n) {
+      return std::max(max_constraint_time + 1, n->g + pathDist(id, n->v));
+    };
+  }
+
+  const auto paths = h_node->paths;
+  const int makespan = paths.getMakespan();
+
+  // update PATH_TABLE
+  updatePathTable(paths, id);
+  FocalHeuristics f2Value = [&](FocalNode* n) {
+    if (n->g == 0) return 0;
+    // last node
+    if (n->g > makespan) {
+      if (PATH_TABLE[makespan][n->v->id] != Solver::NIL) return n->p->f2 + 1;
+    } else {
+      // vertex conflict
+      if (PATH_TABLE[n->g][n->v->id] != Solver::NIL) {
+        return n->p->f2 + 1;
+
+        // swap conflict
+      } else if (PATH_TABLE[n->g][n->p->v->id] != Solver::NIL &&
+                 PATH_TABLE[n->g - 1][n->v->id] ==
+                     PATH_TABLE[n->g][n->p->v->id]) {
+        return n->p->f2 + 1;
+      }
+    }
+    return n->p->f2;
+  };
+
+  CompareFocalNode compareOPEN = [&](FocalNode* a, FocalNode* b) {
+    if (a->f1 != b->f1) return a->f1 > b->f1;
+    return false;
+  };
+
+  CompareFocalNode compareFOCAL = [&](FocalNode* a, FocalNode* b) {
+    if (a->f2 != b->f2) return a->f2 > b->f2;
+    if (a->f1 != b->f1) return a->f1 > b->f1;
+    // avoid other's goal
+    if (isOthersGoal(id, a->v)) return true;
+    if (isOthersGoal(id, b->v)) return false;
+    if (a->g != b->g) return a->g < b->g;
+    return false;
+  };
+
+  CheckFocalFin checkFocalFin = [&](FocalNode* n) {
+    return n->v == g && n->g > max_constraint_time;
+  };
+
+  // different from ECBS, the old plan gives an upper bound
+  const int cost_limit = ub_soc - (h_node->LB - h_node->f_mins[id]);
+
+  CheckInvalidFocalNode checkInvalidFocalNode = [&](FocalNode* m) {
+    if (m->f1 > cost_limit || m->g > max_timestep) return true;
+    for (auto c : constraints) {
+      if (m->g == c->t && m->v == c->v) {
+        // vertex or swap conflict
+        if (c->u == nullptr || c->u == m->p->v) return true;
+      }
+    }
+    // check collisions with agents outside of the problem
+    return reserved_p->isConflicted(m->p->v, m->v, m->g, reserved_ignored);
+  };
+
+  auto p = getTimedPathByFocalSearch(s, g, sub_optimality, f1Value, f2Value,
+                                     compareOPEN, compareFOCAL, checkFocalFin,
+                                     checkInvalidFocalNode);
+  // clear used path table
+  clearPathTable(paths);
+
+  return p;
+}
+
+void ECBS_REFINE::setParams(int argc, char* argv[])
+{
+  ECBS::setParams(argc, argv);
+  solver_name = SOLVER_NAME + "-" + std::to_string(sub_optimality);
+}
@@ -149,7 +149,7 @@ Path ICBS::getConstrainedPath(HighLevelNode_p h_node, int id)
        */
       if (c > mdd.c + THRESHOLD) break;
 
-      LibCBS::MDD_p new_mdd = std::make_shared<LibCBS::MDD>(c, id, this, h_node->constraints);
+      LibCBS::MDD_p new_mdd = getConstrainedMDD(h_node, id, c);
       if (new_mdd->valid) {
         MDDTable[h_node->id][id] = new_mdd;
         return new_mdd->getPath(MT);
@@ -160,6 +160,11 @@ Path ICBS::getConstrainedPath(HighLevelNode_p h_node, int id)
   return {};
 }
 
+LibCBS::MDD_p ICBS::getConstrainedMDD(HighLevelNode_p h_node, int id, int c)
+{
+  return std::make_shared<LibCBS::MDD>(c, id, this, h_node->constraints);
+}
+
 void ICBS::registerLazyEval(const int LB_SOC, HighLevelNode_p h_node)
 {
   auto itr = LAZY_EVAL_TABLE.find(LB_SOC);
@@ -192,7 +197,7 @@ CBS::HighLevelNodes ICBS::lazyEval()
     while (true) {
       ++c;
       if (overCompTime()) break;
-      LibCBS::MDD_p new_mdd = std::make_shared<LibCBS::MDD>(c, id, this, h_node->constraints);
+      LibCBS::MDD_p new_mdd = getConstrainedMDD(h_node, id, c);
       if (new_mdd->valid) {
         MDDTable[h_node->id][id] = new_mdd;
         Path path = new_mdd->getPath(MT);
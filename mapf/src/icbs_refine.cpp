@@ -6,6 +6,13 @@ ICBS_REFINE::ICBS_REFINE(Problem* _P, const Plan& _old_plan,
 {
 }
 
+ICBS_REFINE::ICBS_REFINE(Problem* _P, const Plan& _old_plan,
+                         const ReservationTable* _reserved_p,
+                         const std::vector<int>& _ignored)
+    : CBS(_P), ICBS(_P), CBS_REFINE(_P, _old_plan, _reserved_p, _ignored)
+{
+}
+
 void ICBS_REFINE::setInitialHighLevelNode(HighLevelNode_p n)
 {
   if (modif_list.empty()) {
@@ -16,10 +23,6 @@ void ICBS_REFINE::setInitialHighLevelNode(HighLevelNode_p n)
   Paths paths(P->getNum());
   LibCBS::MDDs mdds;
 
-  // constraints by fixed agents
-  LibCBS::Constraints constraints =
-      LibCBS::getConstraintsByFixedPaths(old_plan, fixed_agents);
-
   // find paths
   for (int i = 0; i < P->getNum(); ++i) {
     // check time limit
@@ -44,7 +47,9 @@ void ICBS_REFINE::setInitialHighLevelNode(HighLevelNode_p n)
       }
       // create mdd
       mdd = std::make_shared<LibCBS::MDD>(
-          LibCBS::MDD(path.size() - 1, i, this, constraints, time_limit));
+          LibCBS::MDD(path.size() - 1, i, this, {}, time_limit));
+      // avoid collisions with fixed agents
+      mdd->update(*reserved_p, reserved_ignored);
       if (!mdd->valid) {
         n->valid = false;
         return;
@@ -58,7 +63,7 @@ void ICBS_REFINE::setInitialHighLevelNode(HighLevelNode_p n)
   }
   n->id = 0;
   n->paths = paths;
-  n->constraints = constraints;
+  n->constraints = {};  // fixed agents are handled by the reservation
   n->makespan = paths.getMakespan();
   n->soc = paths.getSOC();
   n->f = paths.countConflict(modif_list);
@@ -75,6 +80,14 @@ LibCBS::Constraints ICBS_REFINE::getPrioritizedConflict(HighLevelNode_p h_node)
                                         modif_list);
 }
 
+LibCBS::MDD_p ICBS_REFINE::getConstrainedMDD(HighLevelNode_p h_node, int id,
+                                             int c)
+{
+  LibCBS::MDD_p mdd = ICBS::getConstrainedMDD(h_node, id, c);
+  mdd->update(*reserved_p, reserved_ignored);
+  return mdd;
+}
+
 // using MDD
 Path ICBS_REFINE::getConstrainedPath(HighLevelNode_p h_node, int id)
 {
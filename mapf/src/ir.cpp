@@ -1,14 +1,19 @@
 #include "../include/ir.hpp"
 
 #include <fstream>
+#include <limits>
+#include <queue>
 #include <set>
+#include <thread>
 #include "../include/cbs_refine.hpp"
 #include "../include/ecbs.hpp"
+#include "../include/ecbs_refine.hpp"
 #include "../include/hca.hpp"
 #include "../include/winpibt.hpp"
 #include "../include/icbs_refine.hpp"
 #include "../include/pibt.hpp"
 #include "../include/pibt_complete.hpp"
+#include "../include/pp_refine.hpp"
 #include "../include/push_and_swap.hpp"
 #include "../include/revisit_pp.hpp"
 #include "../include/whca.hpp"
@@ -22,23 +27,27 @@ const std::string IR_FOCUS_GOALS::SOLVER_NAME = "IR_FOCUS_GOALS";
 const std::string IR_MDD::SOLVER_NAME = "IR_MDD";
 const std::string IR_BOTTLENECK::SOLVER_NAME = "IR_BOTTLENECK";
 const std::string IR_HYBRID::SOLVER_NAME = "IR_HYBRID";
+const std::string IR_ADAPTIVE::SOLVER_NAME = "IR_ADAPTIVE";
 
 IR::IR(Problem* _P)
     : Solver(_P),
       init_solver(DEFAULT_INIT_SOLVER),
       refine_solver(DEFAULT_REFINE_SOLVER),
+      fallback_suboptimal(false),
       current_iteration(0),
       max_iteration(DEFAULT_MAX_ITERATION),
       output_file(DEFAULT_OUTPUT_FILE),
       make_log_every_itr(false),
       timeout_refinement(DEFAULT_TIMEOUT_REFINEMENT),
       verbose_underlying_solver(false),
-      sampling_num(std::min(DEFAULT_SAMPLING_NUM, P->getNum()))
+      sampling_num(std::min(DEFAULT_SAMPLING_NUM, P->getNum())),
+      thread_num(DEFAULT_THREAD_NUM),
+      skipped_num(0)
 {
   solver_name = IR::SOLVER_NAME;
 }
 
-IR::~IR() {}
+IR::~IR() { stopInitPortfolio(); }
 
 void IR::run()
 {
@@ -48,6 +57,9 @@ void IR::run()
   if (!solved) return;  // failure
   const int init_plan_soc = solution.getSOC();
   const int init_plan_makespan = solution.getMakespan();
+  std::vector<int> A(P->getNum());
+  std::iota(A.begin(), A.end(), 0);
+  reserved = ReservationTable(solution, A);
   HIST.push_back(std::make_tuple(getSolverElapsedTime(), init_plan_soc,
                                  init_plan_makespan));
   info("  init plan", ", comp_time:", getSolverElapsedTime(),
@@ -56,9 +68,21 @@ void IR::run()
   last_makespan = init_plan_makespan;
 
   if (make_log_every_itr) makeLog(output_file);
+  if (!stream_file.empty()) {
+    Grid* grid = reinterpret_cast<Grid*>(P->getG());
+    stream = std::make_unique<SolutionStream>(
+        stream_file, "instance=" + P->getInstanceFileName() + "\n" +
+                         "agents=" + std::to_string(P->getNum()) + "\n" +
+                         "map_file=" + grid->getMapFileName() + "\n" +
+                         "solver=" + solver_name + "\n");
+    pushToStream(A);
+  }
 
   // refinement
   refinePlan();
+  stopInitPortfolio();
+  adoptBetterInitialPlan();
+  if (stream != nullptr) stream->close();
 
   // print final info
   const int soc = solution.getSOC();
@@ -66,19 +90,22 @@ void IR::run()
   info("  refinement results, soc:", init_plan_soc, "->", soc,
        " (improved:", init_plan_soc - soc, ")",
        ", makespan:", init_plan_makespan, "->", solution.getMakespan(),
-       " (improved:", init_plan_makespan - makespan, ")");
+       " (improved:", init_plan_makespan - makespan, ")",
+       ", skipped neighborhoods:", skipped_num);
 }
 
 void IR::updateSolution(const Plan& plan)
 {
   ++current_iteration;
 
+  const auto changed = updateReservation(plan);
   solution = plan;
   const int soc = solution.getSOC();
   const int makespan = solution.getMakespan();
   HIST.push_back(std::make_tuple(getSolverElapsedTime(), soc, makespan));
 
   if (make_log_every_itr) makeLog(output_file);
+  if (stream != nullptr && !changed.empty()) pushToStream(changed);
 
   printProcessInfo();
 
@@ -86,6 +113,38 @@ void IR::updateSolution(const Plan& plan)
   last_makespan = makespan;
 }
 
+std::vector<int> IR::updateReservation(const Plan& plan)
+{
+  std::vector<int> changed;
+  for (int i = 0; i < P->getNum(); ++i) {
+    const Path old_path = solution.getPath(i);
+    const Path new_path = plan.getPath(i);
+    const int cost = getPathCost(new_path);
+    if (cost == getPathCost(old_path) &&
+        std::equal(new_path.begin(), new_path.begin() + cost + 1,
+                   old_path.begin())) {
+      continue;
+    }
+    reserved.remove(i, old_path);
+    reserved.add(i, new_path);
+    changed.push_back(i);
+  }
+  return changed;
+}
+
+void IR::pushToStream(const std::vector<int>& ids)
+{
+  SolutionStream::Record record{current_iteration, getSolverElapsedTime(),
+                                solution.getSOC(), solution.getMakespan(), {}};
+  for (auto i : ids) {
+    // until the last arrival
+    Path path = solution.getPath(i);
+    path.resize(solution.getPathCost(i) + 1);
+    record.paths.emplace_back(i, std::move(path));
+  }
+  stream->push(std::move(record));
+}
+
 void IR::printProcessInfo()
 {
   const int soc = solution.getSOC();
@@ -104,37 +163,54 @@ void IR::setInitialPlan(const Plan& plan) { solution = plan; }
 Plan IR::getInitialPlan()
 {
   if (!solution.empty()) return solution;
+  if (init_solvers.size() > 1) return getInitialPlanByPortfolio();
 
-  // set problem
+  // set problem, the init-solver stops together with IR
   Problem _P = Problem(P, max_comp_time);
+  _P.setCancelToken(token);
 
   // set solver
+  auto solver = getInitSolver(&_P, init_solver);
+
+  // solve
+  solver->solve();
+
+  // success
+  Plan plan;
+  if (solver->succeed()) plan = solver->getSolution();
+
+  return plan;
+}
+
+std::shared_ptr<Solver> IR::getInitSolver(Problem* const _P,
+                                          const INIT_SOLVER_TYPE solver_type)
+{
   std::shared_ptr<Solver> solver;
-  switch (init_solver) {
+  switch (solver_type) {
     case INIT_SOLVER_TYPE::HCA:
-      solver = std::make_shared<HCA>(&_P);
+      solver = std::make_shared<HCA>(_P);
       break;
     case INIT_SOLVER_TYPE::WHCA:
-      solver = std::make_shared<WHCA>(&_P);
+      solver = std::make_shared<WHCA>(_P);
       break;
     case INIT_SOLVER_TYPE::winPIBT:
-      solver = std::make_shared<winPIBT>(&_P);
+      solver = std::make_shared<winPIBT>(_P);
       break;
     case INIT_SOLVER_TYPE::ECBS:
-      solver = std::make_shared<ECBS>(&_P);
+      solver = std::make_shared<ECBS>(_P);
       break;
     case INIT_SOLVER_TYPE::PIBT:
-      solver = std::make_shared<PIBT>(&_P);
+      solver = std::make_shared<PIBT>(_P);
       break;
     case INIT_SOLVER_TYPE::RevisitPP:
-      solver = std::make_shared<RevisitPP>(&_P);
+      solver = std::make_shared<RevisitPP>(_P);
       break;
     case INIT_SOLVER_TYPE::PushAndSwap:
-      solver = std::make_shared<PushAndSwap>(&_P);
+      solver = std::make_shared<PushAndSwap>(_P);
       break;
     case INIT_SOLVER_TYPE::PIBT_COMPLETE:
     default:
-      solver = std::make_shared<PIBT_COMPLETE>(&_P);
+      solver = std::make_shared<PIBT_COMPLETE>(_P);
       break;
   }
 
@@ -143,76 +219,568 @@ Plan IR::getInitialPlan()
   solver->setVerbose(verbose_underlying_solver);
   solver->setDistanceTable(&distance_table);
 
-  // solve
-  solver->solve();
+  return solver;
+}
+
+bool IR::getInitSolverType(const std::string& s, INIT_SOLVER_TYPE& type)
+{
+  if (s == "PIBT") {
+    type = INIT_SOLVER_TYPE::PIBT;
+  } else if (s == "winPIBT") {
+    type = INIT_SOLVER_TYPE::winPIBT;
+  } else if (s == "HCA") {
+    type = INIT_SOLVER_TYPE::HCA;
+  } else if (s == "WHCA") {
+    type = INIT_SOLVER_TYPE::WHCA;
+  } else if (s == "ECBS") {
+    type = INIT_SOLVER_TYPE::ECBS;
+  } else if (s == "RevisitPP") {
+    type = INIT_SOLVER_TYPE::RevisitPP;
+  } else if (s == "PIBT_COMPLETE") {
+    type = INIT_SOLVER_TYPE::PIBT_COMPLETE;
+  } else if (s == "PushAndSwap") {
+    type = INIT_SOLVER_TYPE::PushAndSwap;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+Plan IR::getInitialPlanByPortfolio()
+{
+  portfolio = std::make_unique<InitPortfolio>();
+  auto pf = portfolio.get();
+  pf->token = std::make_shared<CancelToken>(token);
+
+  // setup solvers in advance, options are not thread-safe
+  for (auto solver_type : init_solvers) {
+    pf->MTs.push_back(std::make_unique<std::mt19937>((*MT)()));
+    auto _P = std::make_shared<Problem>(P, max_comp_time);
+    _P->setMT(pf->MTs.back().get());
+    _P->setCancelToken(pf->token);
+    pf->problems.push_back(_P);
+    pf->solvers.push_back(getInitSolver(_P.get(), solver_type));
+  }
+
+  for (auto solver : pf->solvers) {
+    pf->threads.emplace_back([this, solver, pf]() {
+      // errors of one solver do not stop the others
+      bool error = false;
+      try {
+        solver->solve();
+      } catch (const MAPFError& e) {
+        warn(std::string("init-solver failed, ") + e.what());
+        error = true;
+      }
+      std::lock_guard<std::mutex> lock(pf->mtx);
+      ++pf->finished_num;
+      if (!error && solver->succeed()) {
+        pf->plans.push_back(solver->getSolution());
+      }
+      pf->cv.notify_all();
+    });
+  }
+
+  // wait for the first plan
+  const int solvers_num = pf->solvers.size();
+  std::unique_lock<std::mutex> lock(pf->mtx);
+  pf->cv.wait(lock, [&] {
+    return !pf->plans.empty() || pf->finished_num == solvers_num;
+  });
+  if (pf->plans.empty()) return Plan();
+  pf->checked_num = pf->plans.size();
+  return *std::min_element(pf->plans.begin(), pf->plans.end(),
+                           [](const Plan& a, const Plan& b) {
+                             return a.getSOC() < b.getSOC();
+                           });
+}
+
+bool IR::adoptBetterInitialPlan()
+{
+  if (portfolio == nullptr) return false;
+  auto pf = portfolio.get();
 
-  // success
   Plan plan;
-  if (solver->succeed()) plan = solver->getSolution();
+  {
+    std::lock_guard<std::mutex> lock(pf->mtx);
+    const int plans_num = pf->plans.size();
+    for (; pf->checked_num < plans_num; ++pf->checked_num) {
+      const auto& p = pf->plans[pf->checked_num];
+      if (plan.empty() || p.getSOC() < plan.getSOC()) plan = p;
+    }
+  }
+  if (plan.empty() || plan.getSOC() >= solution.getSOC()) return false;
 
-  return plan;
+  info("   ", "adopt a better initial plan, soc:", solution.getSOC(), "->",
+       plan.getSOC());
+  updateSolution(plan);
+  return true;
+}
+
+void IR::stopInitPortfolio()
+{
+  if (portfolio == nullptr) return;
+  portfolio->token->cancel();
+  for (auto& th : portfolio->threads) {
+    if (th.joinable()) th.join();
+  }
 }
 
 void IR::refinePlan() { updateByRandom(); }
 
-std::tuple<bool, Plan> IR::getOptimalPlan(Problem* _P, const Plan& current_plan,
+std::tuple<bool, Plan> IR::getOptimalPlan(const Plan& current_plan,
                                           const std::vector<int>& sample)
 {
+  // solvers for the whole problem, the sample is not used
+  if (refine_solver == OPTIMAL_SOLVER_TYPE::CBS_NORMAL ||
+      refine_solver == OPTIMAL_SOLVER_TYPE::ICBS_NORMAL) {
+    Problem _P = Problem(P, getRefineTimeLimit());
+    _P.setCancelToken(token);
+    std::shared_ptr<Solver> solver;
+    if (refine_solver == OPTIMAL_SOLVER_TYPE::CBS_NORMAL) {
+      solver = std::make_shared<CBS>(&_P);
+    } else {
+      solver = std::make_shared<ICBS>(&_P);
+    }
+    setSolverOption(solver, option_optimal_solver);
+    solver->setVerbose(verbose_underlying_solver);
+    solver->setDistanceTable(&distance_table);
+    solver->solve();
+    if (solver->succeed()) return std::make_tuple(true, solver->getSolution());
+    return std::make_tuple(false, current_plan);
+  }
+
+  std::vector<int> modif_list = sample;
+  std::sort(modif_list.begin(), modif_list.end());
+
+  // skip neighborhoods which failed with the same inputs
+  const bool memorable = isMemorable();
+  std::string name;
+  size_t fingerprint = 0;
+  if (memorable) {
+    name = getNeighborhoodName(modif_list);
+    fingerprint = getNeighborhoodFingerprint(current_plan, modif_list);
+    if (isFailedNeighborhood(name, fingerprint)) {
+      return std::make_tuple(false, current_plan);
+    }
+  }
+
+  auto _P = getSubProblem(modif_list);
+  auto solver =
+      getRefineSolver(_P.get(), current_plan, modif_list, refine_solver);
+
+  // solve
+  solver->solve();
+
+  // timeout -> retry by the bounded-suboptimal solver
+  if (!solver->succeed() && solver->overCompTime() && fallback_suboptimal &&
+      refine_solver != OPTIMAL_SOLVER_TYPE::ECBS && !overCompTime()) {
+    info("   ", "refine-solver reached time limit, fallback to ECBS");
+    _P = getSubProblem(modif_list);
+    solver = getRefineSolver(_P.get(), current_plan, modif_list,
+                             OPTIMAL_SOLVER_TYPE::ECBS);
+    solver->solve();
+  }
+
+  if (memorable) {
+    int old_soc = 0;
+    for (auto i : modif_list) old_soc += current_plan.getPathCost(i);
+    memorizeNeighborhood(
+        name, fingerprint,
+        solver->succeed() && solver->getSolution().getSOC() < old_soc,
+        solver->overCompTime());
+  }
+
+  // failed
+  if (!solver->succeed()) return std::make_tuple(false, current_plan);
+
+  // merge the refined paths
+  Paths paths = planToPaths(current_plan);
+  const Paths sub_paths = planToPaths(solver->getSolution());
+  const int modif_list_size = modif_list.size();
+  for (int k = 0; k < modif_list_size; ++k) {
+    paths.insert(modif_list[k], sub_paths.get(k));
+  }
+  return std::make_tuple(true, pathsToPlan(paths));
+}
+
+/*
+ * create a sub-problem only with agents in the sample,
+ * paths of the others are given by the reservation of the current solution
+ */
+std::shared_ptr<Problem> IR::getSubProblem(const std::vector<int>& modif_list,
+                                           std::mt19937* const _MT)
+{
+  Config config_s, config_g;
+  for (auto i : modif_list) {
+    config_s.push_back(P->getStart(i));
+    config_g.push_back(P->getGoal(i));
+  }
+  auto _P = std::make_shared<Problem>(P, config_s, config_g,
+                                      getRefineTimeLimit(), max_timestep);
+  _P->setCancelToken(token);
+  if (_MT != nullptr) _P->setMT(_MT);
+  return _P;
+}
+
+std::string IR::getNeighborhoodName(const std::vector<int>& modif_list)
+{
+  std::string name;
+  for (auto i : modif_list) name += std::to_string(i) + "-";
+  return name;
+}
+
+static void hashCombine(size_t& seed, const size_t v)
+{
+  seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+bool IR::isMemorable() const
+{
+  // PP depends on random orders, optimal solvers return the same SOC
+  return refine_solver != OPTIMAL_SOLVER_TYPE::PP;
+}
+
+bool IR::isFailedNeighborhood(const std::string& name, const size_t fingerprint)
+{
+  auto itr = failed_neighborhoods.find(name);
+  if (itr == failed_neighborhoods.end() || itr->second != fingerprint) {
+    return false;
+  }
+  ++skipped_num;
+  info("   ", "skip neighborhood without changes");
+  return true;
+}
+
+void IR::memorizeNeighborhood(const std::string& name, const size_t fingerprint,
+                              const bool improved, const bool timeout)
+{
+  if (improved) {
+    failed_neighborhoods.erase(name);
+  } else if (!timeout) {
+    // with more time, the refine-solver might improve it
+    failed_neighborhoods[name] = fingerprint;
+  }
+}
+
+/*
+ * Refined paths of modif_list are bounded by the sum-of-costs in the plan,
+ * hence agent i can be at v at timestep t only when
+ * dist(s_i, v) <= t and t + dist(v, g_i) <= budget, or v = g_i.
+ * Such locations are found by BFS from s_i pruned by the budget,
+ * then agents of the reservation staying there within the windows are
+ * relevant. Agents never entering them do not affect the refinement.
+ */
+size_t IR::getNeighborhoodFingerprint(const Plan& plan,
+                                      const std::vector<int>& modif_list)
+{
+  int ub_soc = 0;
+  int lb_soc = 0;
+  for (auto i : modif_list) {
+    ub_soc += plan.getPathCost(i);
+    lb_soc += pathDist(i);
+  }
+
+  // buffers indexed by node ids, cleared by stamps
+  auto& buf = fingerprint_buffer;
+  const int nodes_size = G->getNodesSize();
+  if ((int)buf.region.size() != nodes_size) {
+    buf.region.assign(nodes_size, 0);
+    buf.visited.assign(nodes_size, 0);
+    buf.dist.resize(nodes_size);
+    buf.t_min.resize(nodes_size);
+    buf.t_max.resize(nodes_size);
+    buf.region_stamp = buf.visit_stamp = 0;
+  }
+  const int region_stamp = ++buf.region_stamp;
+
+  // locations and time windows possibly used by modif_list
+  std::vector<Node*> region;
+  long long windows_size = 0;
+  for (auto i : modif_list) {
+    const int budget = ub_soc - lb_soc + pathDist(i);
+    const int visit_stamp = ++buf.visit_stamp;
+    Node* g = P->getGoal(i);
+    std::queue<Node*> OPEN;
+    OPEN.push(P->getStart(i));
+    buf.visited[P->getStart(i)->id] = visit_stamp;
+    buf.dist[P->getStart(i)->id] = 0;
+    while (!OPEN.empty()) {
+      Node* v = OPEN.front();
+      OPEN.pop();
+      const int d = buf.dist[v->id];
+      const int t_max =
+          (v == g) ? std::numeric_limits<int>::max() : budget - pathDist(i, v);
+      if (buf.region[v->id] != region_stamp) {
+        buf.region[v->id] = region_stamp;
+        buf.t_min[v->id] = d;
+        buf.t_max[v->id] = t_max;
+        region.push_back(v);
+      } else {
+        buf.t_min[v->id] = std::min(buf.t_min[v->id], d);
+        buf.t_max[v->id] = std::max(buf.t_max[v->id], t_max);
+      }
+      for (auto u : v->neighbor) {
+        if (buf.visited[u->id] == visit_stamp) continue;
+        if (d + 1 + pathDist(i, u) > budget) continue;
+        buf.visited[u->id] = visit_stamp;
+        buf.dist[u->id] = d + 1;
+        OPEN.push(u);
+      }
+    }
+  }
+
+  // later than the makespan of the reservation, agents stay at goals
+  const int t_last = reserved.getMakespan() + 1;
+  auto window = [&](Node* v) {
+    return std::make_tuple(std::min(buf.t_min[v->id], t_last),
+                           std::min(buf.t_max[v->id], t_last));
+  };
+  for (auto v : region) {
+    const auto [t_min, t_max] = window(v);
+    windows_size += t_max - t_min + 1;
+  }
+
+  // agents within the windows, looked up by the cheaper way,
+  // the reservation by locations or paths of all agents
+  std::vector<int> relevant = modif_list;
+  if (windows_size <= (long long)plan.getSOC() + P->getNum()) {
+    for (auto v : region) {
+      const auto [t_min, t_max] = window(v);
+      for (int t = t_min; t <= t_max; ++t) {
+        const int j = reserved.get(t, v);
+        if (j != ReservationTable::NIL) relevant.push_back(j);
+      }
+    }
+  } else {
+    for (int j = 0; j < P->getNum(); ++j) {
+      const int cost = plan.getPathCost(j);
+      for (int t = 0; t <= cost; ++t) {
+        Node* v = plan.get(t, j);
+        if (buf.region[v->id] != region_stamp) continue;
+        const auto [t_min, t_max] = window(v);
+        // staying at the goal after the arrival
+        if (t <= t_max && (t_min <= t || t == cost)) {
+          relevant.push_back(j);
+          break;
+        }
+      }
+    }
+  }
+  std::sort(relevant.begin(), relevant.end());
+  relevant.erase(std::unique(relevant.begin(), relevant.end()),
+                 relevant.end());
+
+  // the makespan bounds paths in the refine-solvers
+  size_t seed = plan.getMakespan();
+  for (auto i : relevant) {
+    const int cost = plan.getPathCost(i);
+    hashCombine(seed, i);
+    for (int t = 0; t <= cost; ++t) hashCombine(seed, plan.get(t, i)->id);
+  }
+  return seed;
+}
+
+std::shared_ptr<Solver> IR::getRefineSolver(
+    Problem* const _P, const Plan& current_plan,
+    const std::vector<int>& modif_list, const OPTIMAL_SOLVER_TYPE solver_type)
+{
+  // paths of the sample, aligned with current_plan
+  Plan sub_plan;
+  const int makespan = current_plan.getMakespan();
+  for (int t = 0; t <= makespan; ++t) {
+    Config c;
+    for (auto i : modif_list) c.push_back(current_plan.get(t, i));
+    sub_plan.add(c);
+  }
+
   // set solver
   std::shared_ptr<Solver> solver;
-  switch (refine_solver) {
-    case OPTIMAL_SOLVER_TYPE::CBS_NORMAL:
-      solver = std::make_shared<CBS>(_P);
-      break;
+  switch (solver_type) {
     case OPTIMAL_SOLVER_TYPE::CBS:
-      solver = std::make_shared<CBS_REFINE>(_P, current_plan, sample);
+      solver =
+          std::make_shared<CBS_REFINE>(_P, sub_plan, &reserved, modif_list);
+      break;
+    case OPTIMAL_SOLVER_TYPE::PP:
+      solver =
+          std::make_shared<PP_REFINE>(_P, sub_plan, &reserved, modif_list);
       break;
-    case OPTIMAL_SOLVER_TYPE::ICBS_NORMAL:
-      solver = std::make_shared<ICBS>(_P);
+    case OPTIMAL_SOLVER_TYPE::ECBS:
+      solver =
+          std::make_shared<ECBS_REFINE>(_P, sub_plan, &reserved, modif_list);
       break;
     case OPTIMAL_SOLVER_TYPE::ICBS:
     default:
-      solver = std::make_shared<ICBS_REFINE>(_P, current_plan, sample);
+      solver =
+          std::make_shared<ICBS_REFINE>(_P, sub_plan, &reserved, modif_list);
       break;
   }
 
   // set solver option
   setSolverOption(solver, option_optimal_solver);
   solver->setVerbose(verbose_underlying_solver);
-  solver->setDistanceTable(&distance_table);
+  solver->setDistanceTable(&distance_table, modif_list);
+  solver->setMDDTable(getMDDTable());
 
-  // solve
-  solver->solve();
+  return solver;
+}
 
-  Plan plan = current_plan;
-  bool success = false;
+// ====================================================
+void IR::updateByRandom()
+{
+  // solvers for the whole problem cannot be parallelized
+  if (thread_num > 1 && refine_solver != OPTIMAL_SOLVER_TYPE::CBS_NORMAL &&
+      refine_solver != OPTIMAL_SOLVER_TYPE::ICBS_NORMAL) {
+    updateByRandomInParallel();
+    return;
+  }
 
-  // success
-  if (solver->succeed()) {
-    plan = solver->getSolution();
-    success = true;
+  while (!overCompTime() && current_iteration < max_iteration) {
+    updateByRandomOnce(sampling_num);
   }
+}
 
-  return std::make_tuple(success, plan);
+void IR::updateByRandomOnce(const int num)
+{
+  adoptBetterInitialPlan();
+
+  // pickup several agents randomly
+  std::vector<int> A(P->getNum());
+  std::iota(A.begin(), A.end(), 0);
+  std::shuffle(A.begin(), A.end(), *MT);
+  std::vector<int> modif_list(A.begin(), A.begin() + num);
+  updateSolution(std::get<1>(getOptimalPlan(solution, modif_list)));
 }
 
-// ====================================================
-void IR::updateByRandom()
+void IR::updateByRandomInParallel()
 {
-  Plan plan = solution;
   std::vector<int> A(P->getNum());
   std::iota(A.begin(), A.end(), 0);
+  const int num = std::max(1, std::min(thread_num, P->getNum() / sampling_num));
+  mdd_tables.resize(num - 1);
+
   while (!overCompTime() && current_iteration < max_iteration) {
-    // pickup several agents randomly
+    adoptBetterInitialPlan();
+
+    // pickup disjoint neighborhoods randomly
     std::shuffle(A.begin(), A.end(), *MT);
-    std::vector<int> modif_list(sampling_num);
-    std::copy(A.begin(), A.begin() + sampling_num, modif_list.begin());
-    Problem _P = Problem(P, getRefineTimeLimit());
-    plan = std::get<1>(getOptimalPlan(&_P, plan, modif_list));
-    updateSolution(plan);
+    std::vector<std::vector<int>> modif_lists(num);
+    std::vector<std::mt19937> MTs;  // each thread has its own seed
+    for (int k = 0; k < num; ++k) {
+      modif_lists[k].assign(A.begin() + k * sampling_num,
+                            A.begin() + (k + 1) * sampling_num);
+      std::sort(modif_lists[k].begin(), modif_lists[k].end());
+      MTs.emplace_back((*MT)());
+    }
+
+    // skip neighborhoods which failed with the same inputs
+    const bool memorable = isMemorable();
+    std::vector<std::string> names(num);
+    std::vector<size_t> fingerprints(num, 0);
+    std::vector<bool> skipped(num, false);
+    for (int k = 0; memorable && k < num; ++k) {
+      names[k] = getNeighborhoodName(modif_lists[k]);
+      fingerprints[k] = getNeighborhoodFingerprint(solution, modif_lists[k]);
+      skipped[k] = isFailedNeighborhood(names[k], fingerprints[k]);
+    }
+
+    // setup solvers in advance, options are not thread-safe
+    std::vector<std::shared_ptr<Problem>> problems(num);
+    std::vector<std::shared_ptr<Solver>> solvers(num);
+    for (int k = 0; k < num; ++k) {
+      if (skipped[k]) continue;
+      problems[k] = getSubProblem(modif_lists[k], &MTs[k]);
+      solvers[k] = getRefineSolver(problems[k].get(), solution, modif_lists[k],
+                                   refine_solver);
+      if (k > 0) solvers[k]->setMDDTable(&mdd_tables[k - 1]);
+    }
+
+    // solve concurrently against the same solution
+    // errors are raised again in this thread
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(num);
+    for (int k = 0; k < num; ++k) {
+      if (skipped[k]) continue;
+      threads.emplace_back([&solvers, &errors, k]() {
+        try {
+          solvers[k]->solve();
+        } catch (...) {
+          errors[k] = std::current_exception();
+        }
+      });
+    }
+    for (auto& th : threads) th.join();
+    for (auto& e : errors) {
+      if (e) std::rethrow_exception(e);
+    }
+
+    // merge compatible results
+    std::vector<Plan> sub_plans(num);
+    for (int k = 0; k < num; ++k) {
+      if (skipped[k]) continue;
+      if (solvers[k]->succeed()) sub_plans[k] = solvers[k]->getSolution();
+      // discarded ones due to conflicts are improvements
+      if (memorable) {
+        int old_soc = 0;
+        for (auto i : modif_lists[k]) old_soc += solution.getPathCost(i);
+        memorizeNeighborhood(
+            names[k], fingerprints[k],
+            !sub_plans[k].empty() && sub_plans[k].getSOC() < old_soc,
+            solvers[k]->overCompTime());
+      }
+    }
+    const auto res = commitImprovements(solution, modif_lists, sub_plans);
+    for (auto k : std::get<2>(res)) {
+      info("   ", "discard neighborhood due to conflicts, size:",
+           modif_lists[k].size());
+    }
+
+    updateSolution(std::get<0>(res));
   }
 }
 
+std::tuple<Plan, std::vector<int>, std::vector<int>> IR::commitImprovements(
+    const Plan& plan, const std::vector<std::vector<int>>& modif_lists,
+    const std::vector<Plan>& sub_plans)
+{
+  // sort results by improvement
+  std::vector<std::tuple<int, int>> improvements;  // improvement, index
+  const int num = modif_lists.size();
+  for (int k = 0; k < num; ++k) {
+    if (sub_plans[k].empty()) continue;
+    int old_soc = 0;
+    for (auto i : modif_lists[k]) old_soc += plan.getPathCost(i);
+    const int diff = old_soc - sub_plans[k].getSOC();
+    if (diff > 0) improvements.push_back(std::make_tuple(diff, k));
+  }
+  std::sort(improvements.begin(), improvements.end(),
+            std::greater<std::tuple<int, int>>());
+
+  // commit results unless new paths collide with already committed ones
+  Paths paths = planToPaths(plan);
+  ReservationTable committed;
+  std::vector<int> committed_list, discarded_list;
+  for (auto itr : improvements) {
+    const int k = std::get<1>(itr);
+    const Paths sub_paths = planToPaths(sub_plans[k]);
+    const int modif_list_size = modif_lists[k].size();
+    bool conflicted = false;
+    for (int l = 0; l < modif_list_size && !conflicted; ++l) {
+      conflicted = committed.isConflicted(sub_paths.get(l));
+    }
+    if (conflicted) {
+      discarded_list.push_back(k);
+      continue;
+    }
+    for (int l = 0; l < modif_list_size; ++l) {
+      committed.add(modif_lists[k][l], sub_paths.get(l));
+      paths.insert(modif_lists[k][l], sub_paths.get(l));
+    }
+    committed_list.push_back(k);
+  }
+  return std::make_tuple(pathsToPlan(paths), committed_list, discarded_list);
+}
+
 void IR::updatePlanFocusOneAgent(std::function<void(const int, Plan&, IR*)> fn)
 {
   Plan plan = solution;
@@ -222,6 +790,7 @@ void IR::updatePlanFocusOneAgent(std::function<void(const int, Plan&, IR*)> fn)
     last_itr_soc = plan.getSOC();
     for (int i = 0; i < P->getNum(); ++i) {
       if (overCompTime() || current_iteration >= max_iteration) break;
+      if (adoptBetterInitialPlan()) plan = solution;
       if (plan.getPathCost(i) - pathDist(i) == 0) continue;
       // pickup one agent and apply fn
       fn(i, plan, this);
@@ -312,8 +881,7 @@ void IR::updateByFocusGoals(const int i, Plan& plan, IR* const solver)
   const auto P = solver->getP();
   const auto modif_list = identifyAgentsAtGoal(i, plan, P->getGoal(i), solver->pathDist(i));
   if (modif_list.empty()) return;
-  Problem _P = Problem(P, solver->getRefineTimeLimit());
-  plan = std::get<1>(solver->getOptimalPlan(&_P, plan, modif_list));
+  plan = std::get<1>(solver->getOptimalPlan(plan, modif_list));
   solver->updateSolution(plan);
 }
 
@@ -322,19 +890,16 @@ void IR::updateByBottleneck(const int i, Plan& plan, IR* const solver)
   const auto modif_list = std::get<1>(IR::identifyBottleneckAgentsWithScore
                                       (i, planToPaths(plan), solver, solver->getRefineTimeLimit()));
   if (modif_list.empty()) return;
-  Problem _P = Problem(solver->getP(), solver->getRefineTimeLimit());
-  plan = std::get<1>(solver->getOptimalPlan(&_P, plan, modif_list));
+  plan = std::get<1>(solver->getOptimalPlan(plan, modif_list));
   solver->updateSolution(plan);
 }
 
 void IR::updateByMDD(const int i, Plan& plan, IR* const solver)
 {
-  const auto P = solver->getP();
   const auto modif_list = IR::identifyInteractingSetByMDD(
-      i, plan, solver, true, solver->getRefineTimeLimit(), P->getMT());
+      i, plan, solver, true, solver->getRefineTimeLimit(), solver->MT);
   if (modif_list.empty()) return;
-  Problem _P = Problem(P, solver->getRefineTimeLimit());
-  plan = std::get<1>(solver->getOptimalPlan(&_P, plan, modif_list));
+  plan = std::get<1>(solver->getOptimalPlan(plan, modif_list));
   solver->updateSolution(plan);
 }
 
@@ -455,13 +1020,17 @@ void IR::setParams(int argc, char* argv[])
       {"verbose-underlying", no_argument, 0, 'V'},
       {"max-iteration", required_argument, 0, 'n'},
       {"sampling-num", required_argument, 0, 'S'},
+      {"threads", required_argument, 0, 'j'},
+      {"fallback-suboptimal", no_argument, 0, 'F'},
+      {"stream", required_argument, 0, 'L'},
       {0, 0, 0, 0},
   };
   optind = 1;  // reset
   int opt, longindex, s_size;
   std::string s, s_tmp;
+  INIT_SOLVER_TYPE init_solver_type;
 
-  while ((opt = getopt_long(argc, argv, "o:lt:x:y:X:Y:Vn:S:", longopts,
+  while ((opt = getopt_long(argc, argv, "o:lt:x:y:X:Y:Vn:S:j:FL:", longopts,
                             &longindex)) != -1) {
     switch (opt) {
       case 'o':
@@ -470,6 +1039,9 @@ void IR::setParams(int argc, char* argv[])
       case 'l':
         make_log_every_itr = true;
         break;
+      case 'L':
+        stream_file = std::string(optarg);
+        break;
       case 't':
         timeout_refinement = std::atoi(optarg);
         if (timeout_refinement < 0 || max_comp_time < timeout_refinement) {
@@ -478,30 +1050,28 @@ void IR::setParams(int argc, char* argv[])
         }
         break;
       case 'x':
-        s = std::string(optarg);
-        if (s == "PIBT") {
-          init_solver = INIT_SOLVER_TYPE::PIBT;
-        } else if (s == "winPIBT") {
-          init_solver = INIT_SOLVER_TYPE::winPIBT;
-        } else if (s == "HCA") {
-          init_solver = INIT_SOLVER_TYPE::HCA;
-        } else if (s == "WHCA") {
-          init_solver = INIT_SOLVER_TYPE::WHCA;
-        } else if (s == "ECBS") {
-          init_solver = INIT_SOLVER_TYPE::ECBS;
-        } else if (s == "RevisitPP") {
-          init_solver = INIT_SOLVER_TYPE::RevisitPP;
-        } else if (s == "PIBT_COMPLETE") {
-          init_solver = INIT_SOLVER_TYPE::PIBT_COMPLETE;
-        } else if (s == "PushAndSwap") {
-          init_solver = INIT_SOLVER_TYPE::PushAndSwap;
-        } else {
-          warn("solver does not exists, use PIBT");
+        // comma-separated names -> portfolio
+        init_solvers.clear();
+        s = std::string(optarg) + ",";
+        s_tmp = "";
+        for (auto c : s) {
+          if (c != ',') {
+            s_tmp += c;
+            continue;
+          }
+          if (getInitSolverType(s_tmp, init_solver_type)) {
+            init_solvers.push_back(init_solver_type);
+          } else {
+            warn("solver " + s_tmp + " does not exists, ignored");
+          }
+          s_tmp = "";
         }
+        if (!init_solvers.empty()) init_solver = init_solvers[0];
         break;
       case 'X':
         s = std::string(optarg);
         s_size = s.size();
+        s_tmp = "";
         for (int i = 0; i < s_size; ++i) {
           if (s[i] == ' ') {
             option_init_solver.push_back(s_tmp);
@@ -522,6 +1092,10 @@ void IR::setParams(int argc, char* argv[])
           refine_solver = OPTIMAL_SOLVER_TYPE::ICBS;
         } else if (s == "ICBS_NORMAL") {
           refine_solver = OPTIMAL_SOLVER_TYPE::ICBS_NORMAL;
+        } else if (s == "PP") {
+          refine_solver = OPTIMAL_SOLVER_TYPE::PP;
+        } else if (s == "ECBS") {
+          refine_solver = OPTIMAL_SOLVER_TYPE::ECBS;
         } else {
           warn("solver does not exists, use ICBS");
         }
@@ -529,13 +1103,14 @@ void IR::setParams(int argc, char* argv[])
       case 'Y':
         s = std::string(optarg);
         s_size = s.size();
+        s_tmp = "";
         for (int i = 0; i < s_size; ++i) {
           if (s[i] == ' ') {
             option_optimal_solver.push_back(s_tmp);
             s_tmp = "";
           } else {
             s_tmp += s[i];
-            if (i == s_size) option_optimal_solver.push_back(s_tmp);
+            if (i == s_size - 1) option_optimal_solver.push_back(s_tmp);
           }
         }
         break;
@@ -548,6 +1123,12 @@ void IR::setParams(int argc, char* argv[])
       case 'S':
         sampling_num = std::min(std::atoi(optarg), P->getNum());
         break;
+      case 'j':
+        thread_num = std::max(1, std::atoi(optarg));
+        break;
+      case 'F':
+        fallback_suboptimal = true;
+        break;
       default:
         break;
     }
@@ -562,6 +1143,10 @@ void IR::printHelp()
       << "           "
       << "make log for every iteration\n"
 
+      << "  -L --stream [FILE_PATH]"
+      << "       "
+      << "append improved paths to the file asynchronously\n"
+
       << "  -t --timeout-refinement [INT]"
       << " "
       << "timeout for refinement\n"
@@ -570,6 +1155,8 @@ void IR::printHelp()
       << "     "
       << "init solver: { PIBT, HCA, WHCA, PIBT_COMPLETE, ECBS, winPIBT, RevisitPP }, default: "
          "PIBT_COMPLETE\n"
+      << "                                "
+      << "comma-separated solvers run concurrently, e.g., PIBT_COMPLETE,ECBS\n"
 
       << "  -X --option-init-solver [\"OPTION\"]\n"
       << "                                "
@@ -577,7 +1164,7 @@ void IR::printHelp()
 
       << "  -y --refine-solver [SOLVER]"
       << "   "
-      << "refine solver: { CBS, CBS_USUAL, ICBS, ICBS_USUAL }, default: ICBS\n"
+      << "refine solver: { CBS, CBS_USUAL, ICBS, ICBS_USUAL, PP, ECBS }, default: ICBS\n"
 
       << "  -Y --option-refine-solver [\"OPTION\"]\n"
       << "                                "
@@ -589,15 +1176,21 @@ void IR::printHelp()
 
       << "  -S --sampling-num [INT]"
       << "       "
-      << "number of sampling"
+      << "number of sampling\n"
+
+      << "  -j --threads [INT]"
+      << "            "
+      << "number of neighborhoods refined in parallel, default: 1\n"
+
+      << "  -F --fallback-suboptimal"
+      << "      "
+      << "use ECBS when the refine-solver reaches its time limit"
 
       << std::endl;
 }
 
-void IR::makeLog(const std::string& logfile)
+void IR::writeLog(std::ostream& log)
 {
-  std::ofstream log;
-  log.open(logfile, std::ios::out);
   makeLogBasicInfo(log);
 
   // record the data of each iteration
@@ -611,7 +1204,6 @@ void IR::makeLog(const std::string& logfile)
   }
 
   makeLogSolution(log);
-  log.close();
 }
 
 // ---------------------------------
@@ -628,3 +1220,87 @@ void IR_HYBRID::refinePlan()
   info("", "update by RANDOM");
   updateByRandom();
 }
+
+// ---------------------------------
+// IR_ADAPTIVE
+// ---------------------------------
+void IR_ADAPTIVE::refinePlan()
+{
+  // rules focusing one agent, RANDOM is treated separately
+  const std::vector<std::function<void(const int, Plan&, IR*)>> rules = {
+      updateByFixAtGoals, updateByFocusGoals, updateByMDD, updateByBottleneck};
+  const std::vector<std::string> rule_names = {
+      "FIX_AT_GOALS", "FOCUS_GOALS", "MDD", "BOTTLENECK", "RANDOM"};
+  const int rules_num = rules.size();
+  weights.assign(rules_num + 1, INIT_WEIGHT);
+
+  // candidates of sampling sizes
+  std::set<int> sizes = {std::max(2, sampling_num / 2), sampling_num,
+                         sampling_num * 2};
+  sampling_sizes.clear();
+  for (auto size : sizes) {
+    if (size <= P->getNum()) sampling_sizes.push_back(size);
+  }
+  if (sampling_sizes.empty()) sampling_sizes.push_back(P->getNum());
+  weights_sampling.assign(sampling_sizes.size(), INIT_WEIGHT);
+
+  std::vector<int> delayed_agents;
+  while (!overCompTime() && current_iteration < max_iteration) {
+    adoptBetterInitialPlan();
+
+    // agents not following the shortest paths
+    delayed_agents.clear();
+    for (int i = 0; i < P->getNum(); ++i) {
+      if (solution.getPathCost(i) > pathDist(i)) delayed_agents.push_back(i);
+    }
+    if (delayed_agents.empty()) break;  // optimal
+
+    const int soc = solution.getSOC();
+    const int itr = current_iteration;
+    const auto t_s = Time::now();
+
+    // apply one rule
+    const int k = selectByRoulette(weights, MT);
+    int l = -1;  // index of sampling sizes
+    if (k < rules_num) {
+      Plan plan = solution;
+      rules[k](randomChoose(delayed_agents, MT), plan, this);
+    } else {
+      l = selectByRoulette(weights_sampling, MT);
+      updateByRandomOnce(sampling_sizes[l]);
+    }
+    // rules may return without updating, each step counts as an iteration
+    if (current_iteration == itr) ++current_iteration;
+
+    // update weights
+    const double reward =
+        (double)(soc - solution.getSOC()) / (getElapsedTime(t_s) + 1);
+    updateWeight(weights[k], reward);
+    if (l >= 0) updateWeight(weights_sampling[l], reward);
+    info("   ", "rule:", rule_names[k],
+         (l >= 0 ? ", sampling:" + std::to_string(sampling_sizes[l]) : ""),
+         ", reward:", reward);
+  }
+}
+
+int IR_ADAPTIVE::selectByRoulette(const std::vector<double>& _weights,
+                                  std::mt19937* const MT)
+{
+  const int size = _weights.size();
+  double sum = 0;
+  for (auto w : _weights) sum += w;
+  if (sum <= 0 || getRandomFloat(0, 1, MT) < EXPLORATION) {
+    return getRandomInt(0, size - 1, MT);
+  }
+  double r = getRandomFloat(0, sum, MT);
+  for (int k = 0; k < size; ++k) {
+    r -= _weights[k];
+    if (r <= 0) return k;
+  }
+  return size - 1;
+}
+
+void IR_ADAPTIVE::updateWeight(double& weight, const double reward)
+{
+  weight = (1 - REACTION) * weight + REACTION * reward;
+}
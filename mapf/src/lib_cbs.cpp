@@ -1,8 +1,5 @@
 #include "../include/lib_cbs.hpp"
 
-// cache
-std::unordered_map<std::string, LibCBS::MDD_p> LibCBS::MDD::PURE_MDD_TABLE;
-
 void LibCBS::Constraint::println()
 {
   if (u == nullptr) {
@@ -279,12 +276,13 @@ void LibCBS::MDD::copy(const MDD& other)
 
 void LibCBS::MDD::build(int time_limit)
 {
-  auto t_s = Time::now();
+  CancelPoller poller(solver->getCancelToken().get(), time_limit);
   // impossible
   if (!valid) return;
   // check registered
-  auto itr = PURE_MDD_TABLE.find(getPureMDDName());
-  if (itr != PURE_MDD_TABLE.end()) {
+  auto table = solver->getMDDTable();
+  auto itr = table->find(getPureMDDName());
+  if (itr != table->end()) {
     valid = itr->second->valid;
     copy(*(itr->second));
     return;
@@ -297,8 +295,8 @@ void LibCBS::MDD::build(int time_limit)
     MDDNodes nodes_at_t = body[t];
     MDDNodes nodes_at_t_next;
     for (auto node : nodes_at_t) {
-      // check time limit
-      if (time_limit > 0 && getElapsedTime(t_s) > time_limit) {
+      // check time limit and cancellation
+      if (poller.stop()) {
         valid = false;
         return;
       }
@@ -331,7 +329,7 @@ void LibCBS::MDD::build(int time_limit)
   }
 
   // register a new MDD without conflicts
-  PURE_MDD_TABLE[getPureMDDName()] = std::make_shared<MDD>(*this);
+  (*table)[getPureMDDName()] = std::make_shared<MDD>(*this);
 }
 
 void LibCBS::MDD::update(const Constraints& _constraints)
@@ -401,6 +399,54 @@ void LibCBS::MDD::update(const Constraints& _constraints)
   if (body[0].empty() || body[c].empty()) valid = false;
 }
 
+void LibCBS::MDD::update(const ReservationTable& table,
+                         const std::vector<int>& ignored)
+{
+  if (!valid || table.empty()) return;
+
+  // someone uses the goal after c, must increase cost
+  for (int t = c; t <= std::max(c, table.getMakespan() + 1); ++t) {
+    if (table.get(t, g, ignored) != ReservationTable::NIL) {
+      valid = false;
+      return;
+    }
+  }
+
+  // delete nodes
+  for (int t = 1; t <= c; ++t) {
+    MDDNodes nodes = body[t];
+    for (auto node_v : nodes) {
+      // already deleted
+      if (!inArray(node_v, body[t])) continue;
+      // vertex conflict
+      if (table.get(t, node_v->v, ignored) != ReservationTable::NIL) {
+        deleteForward(node_v);
+        deleteBackword(node_v);
+        continue;
+      }
+      // swap conflict, u->v
+      MDDNodes prev_nodes = node_v->prev;
+      for (auto node_u : prev_nodes) {
+        if (!table.isConflicted(node_u->v, node_v->v, t, ignored)) continue;
+        auto itr_vu =
+            std::find(node_v->prev.begin(), node_v->prev.end(), node_u);
+        auto itr_uv =
+            std::find(node_u->next.begin(), node_u->next.end(), node_v);
+        node_v->prev.erase(itr_vu);
+        node_u->next.erase(itr_uv);
+        if (node_u->next.empty()) deleteBackword(node_u);
+        if (node_v->prev.empty()) {
+          deleteForward(node_v);
+          break;
+        }
+      }
+    }
+  }
+
+  // update validity
+  if (body[0].empty() || body[c].empty()) valid = false;
+}
+
 bool LibCBS::MDD::forceUpdate(const Constraints& _constraints)
 {
   bool updated = false;
@@ -584,7 +630,5 @@ void LibCBS::MDD::println() const
 
 void LibCBS::MDD::halt(const std::string& msg) const
 {
-  std::cout << "error@MDD: " << msg << std::endl;
-  this->~MDD();
-  std::exit(1);
+  throw MAPFError("error@MDD: " + msg);
 }
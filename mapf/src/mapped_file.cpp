@@ -0,0 +1,48 @@
+#include "../include/mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <climits>
+
+MappedFile::MappedFile(const std::string& file_name)
+    : buf(nullptr), buf_size(0), opened(false)
+{
+  const int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    opened = true;
+    buf_size = st.st_size;
+    if (buf_size > 0) {
+      void* p = mmap(nullptr, buf_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        opened = false;
+        buf_size = 0;
+      } else {
+        buf = static_cast<const char*>(p);
+      }
+    }
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (buf != nullptr) munmap(const_cast<char*>(buf), buf_size);
+}
+
+bool parseUInt(const char* s, const char* e, int& v)
+{
+  if (s == e) return false;
+  long long x = 0;
+  for (; s < e; ++s) {
+    if (*s < '0' || *s > '9') return false;
+    x = x * 10 + (*s - '0');
+    if (x > INT_MAX) return false;
+  }
+  v = (int)x;
+  return true;
+}
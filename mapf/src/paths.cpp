@@ -217,9 +217,7 @@ int Paths::countConflict(int id, const Path& path) const
 
 void Paths::halt(const std::string& msg) const
 {
-  std::cout << "error@Paths: " << msg << std::endl;
-  this->~Paths();
-  std::exit(1);
+  throw MAPFError("error@Paths: " + msg);
 }
 
 void Paths::warn(const std::string& msg) const
@@ -12,85 +12,27 @@ PIBT::PIBT(Problem* _P)
 
 void PIBT::run()
 {
-  // compare priority of agents
-  auto compare = [](Agent* a, const Agent* b) {
-    if (a->elapsed != b->elapsed) return a->elapsed < b->elapsed;
-    // use initial distance
-    if (a->init_d != b->init_d) return a->init_d < b->init_d;
-    return a->tie_breaker < b->tie_breaker;
-  };
-
-  // agents have not decided their next locations
-  std::priority_queue<Agent*, Agents, decltype(compare)> undecided(compare);
-  // agents have already decided their next locations
-  std::vector<Agent*> decided;
-
-  // initialize
-  for (int i = 0; i < P->getNum(); ++i) {
-    Node* s = P->getStart(i);
-    Node* g = P->getGoal(i);
-    int d = disable_dist_init ? 0 : pathDist(i);
-    Agent* a = new Agent{i,                          // id
-                         s,                          // current location
-                         nullptr,                    // next location
-                         g,                          // goal
-                         0,                          // elapsed
-                         d,                          // dist from s -> g
-                         getRandomFloat(0, 1, MT)};  // tie-breaker
-    undecided.push(a);
-    occupied_now[s->id] = a;
-  }
+  initSteps();
   solution.add(P->getConfigStart());
 
+  const Config goals = P->getConfigGoal();
+  Config config = P->getConfigStart();
+  Config next(P->getNum(), nullptr);
+
   // main loop
   int timestep = 0;
   while (true) {
     info(" ", "elapsed:", getSolverElapsedTime(), ", timestep:", timestep);
 
-    // planning
-    while (!undecided.empty()) {
-      // pickup the agent with highest priority
-      Agent* a = undecided.top();
-      undecided.pop();
-
-      // if the agent has next location, then skip
-      if (a->v_next == nullptr) {
-        // determine its next location
-        funcPIBT(a);
-      }
-      decided.push_back(a);
-    }
-
-    // acting
-    bool check_goal_cond = true;
-    Config config(P->getNum(), nullptr);
-    for (auto a : decided) {
-      // clear
-      if (occupied_now[a->v_now->id] == a) occupied_now[a->v_now->id] = nullptr;
-      occupied_next[a->v_next->id] = nullptr;
-
-      // set next location
-      config[a->id] = a->v_next;
-      occupied_now[a->v_next->id] = a;
-      // check goal condition
-      check_goal_cond &= (a->v_next == a->g);
-      // update priority
-      a->elapsed = (a->v_next == a->g) ? 0 : a->elapsed + 1;
-      // reset params
-      a->v_now = a->v_next;
-      a->v_next = nullptr;
-      // push to priority queue
-      undecided.push(a);
-    }
-    decided.clear();
+    step(config, next);
 
     // update plan
-    solution.add(config);
+    solution.add(next);
 
     ++timestep;
 
     // success
-    if (check_goal_cond) {
+    if (sameConfig(next, goals)) {
       solved = true;
       break;
     }
@@ -99,13 +41,104 @@ void PIBT::run()
     if (timestep >= max_timestep || overCompTime()) {
       break;
     }
+
+    std::swap(config, next);
   }
+}
 
-  // memory clear
-  while (!undecided.empty()) {
-    delete undecided.top();
-    undecided.pop();
+void PIBT::initSteps()
+{
+  const int num_agents = P->getNum();
+  agents.clear();
+  agents.reserve(num_agents);
+  std::fill(occupied_now.begin(), occupied_now.end(), nullptr);
+  std::fill(occupied_next.begin(), occupied_next.end(), nullptr);
+  for (int i = 0; i < num_agents; ++i) {
+    Node* s = P->getStart(i);
+    Node* g = P->getGoal(i);
+    int d = disable_dist_init ? 0 : pathDist(i);
+    agents.push_back({i,                           // id
+                      s,                           // current location
+                      nullptr,                     // next location
+                      g,                           // goal
+                      0,                           // elapsed
+                      d,                           // dist from s -> g
+                      getRandomFloat(0, 1, MT)});  // tie-breaker
+    occupied_now[s->id] = &agents[i];
   }
+
+  // priorities, higher elapsed, init_d and tie-breaker first
+  order_static.clear();
+  for (auto& a : agents) order_static.push_back(&a);
+  std::sort(order_static.begin(), order_static.end(), [](Agent* a, Agent* b) {
+    if (a->init_d != b->init_d) return a->init_d > b->init_d;
+    return a->tie_breaker > b->tie_breaker;
+  });
+  order = order_static;
+  order_buf.reserve(num_agents);
+}
+
+void PIBT::step(const Config& config, Config& next)
+{
+  // locations might differ from the plan, e.g., delays of robots
+  for (auto& a : agents) {
+    if (config[a.id] != a.v_now && occupied_now[a.v_now->id] == &a) {
+      occupied_now[a.v_now->id] = nullptr;
+    }
+  }
+  for (auto& a : agents) {
+    a.v_now = config[a.id];
+    occupied_now[a.v_now->id] = &a;
+  }
+
+  // planning
+  planNextLocations();
+
+  // acting
+  for (auto a : order) {
+    // clear
+    if (occupied_now[a->v_now->id] == a) occupied_now[a->v_now->id] = nullptr;
+    occupied_next[a->v_next->id] = nullptr;
+
+    // set next location
+    next[a->id] = a->v_next;
+    occupied_now[a->v_next->id] = a;
+    // update priority
+    updatePriority(a);
+    // reset params
+    a->v_now = a->v_next;
+    a->v_next = nullptr;
+  }
+
+  // update the order incrementally;
+  // elapsed of agents not at goals increases uniformly, keeping their order,
+  // agents at goals follow them in the static order
+  order_buf.clear();
+  for (auto a : order) {
+    if (a->elapsed > 0) order_buf.push_back(a);
+  }
+  for (auto a : order_static) {
+    if (a->elapsed == 0) order_buf.push_back(a);
+  }
+  std::swap(order, order_buf);
+}
+
+void PIBT::planNextLocations()
+{
+  for (auto a : order) {
+    // if the agent has next location, then skip
+    if (a->v_next == nullptr) {
+      // determine its next location
+      funcPIBT(a);
+    }
+  }
+}
+
+Config PIBT::step(const Config& config)
+{
+  Config next(config.size(), nullptr);
+  step(config, next);
+  return next;
 }
 
 bool PIBT::funcPIBT(Agent* ai)
@@ -151,8 +184,9 @@ Node* PIBT::planOneStep(Agent* a)
 // no candidate node -> return nullptr
 Node* PIBT::chooseNode(Agent* a)
 {
-  // candidates
-  Nodes C = a->v_now->neighbor;
+  // candidates, the buffer is reused
+  C.clear();
+  for (auto u : a->v_now->neighbor) C.push_back(u);
   C.push_back(a->v_now);
 
   // randomize
@@ -176,8 +210,8 @@ Node* PIBT::chooseNode(Agent* a)
     if (v == nullptr) {
       v = u;
     } else {
-      int c_v = pathDist(a->id, v);
-      int c_u = pathDist(a->id, u);
+      int c_v = goalDist(a, v);
+      int c_u = goalDist(a, u);
       if ((c_u < c_v) || (c_u == c_v && occupied_now[v->id] != nullptr &&
                           occupied_now[u->id] == nullptr)) {
         v = u;
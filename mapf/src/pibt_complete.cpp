@@ -28,6 +28,7 @@ void PIBT_COMPLETE::run()
   // solve by PIBT
   Problem _P = Problem(P, P->getConfigStart(), P->getConfigGoal(),
                        max_comp_time, LB_makespan);
+  _P.setCancelToken(token);
   std::unique_ptr<Solver> init_solver = std::make_unique<PIBT>(&_P);
   init_solver->setDistanceTable((distance_table_p == nullptr)
                                 ? &distance_table
@@ -42,38 +43,139 @@ void PIBT_COMPLETE::run()
   } else {  // PIBT failed
 
     auto t_complement = Time::now();
-
-    // solved by ICBS
-    Problem _Q = Problem(P, solution.last(), P->getConfigGoal(),
-                         getRemainedTime(), max_timestep - LB_makespan);
-    std::shared_ptr<Solver> comp_solver;
-    switch (comp_solver_type) {
-      case COMP_SOLVER_TYPE::ICBS:
-        comp_solver = std::make_shared<ICBS>(&_Q);
-        break;
-      case COMP_SOLVER_TYPE::ECBS:
-        comp_solver = std::make_shared<ECBS>(&_Q);
-        break;
-      default:
-        comp_solver = std::make_shared<PushAndSwap>(&_Q);
-        break;
+    if (comp_solver_types.size() > 1) {
+      solved = complementByRace(solution.last(), max_timestep - LB_makespan);
+    } else {
+      solved = complement(solution.last(), max_timestep - LB_makespan);
     }
+    comp_time_complement = getElapsedTime(t_complement);
+  }
+}
 
-    // set solver options
-    setSolverOption(comp_solver, option_comp_solver);
-    comp_solver->setDistanceTable(
-        (distance_table_p == nullptr) ? &distance_table : distance_table_p);
+bool PIBT_COMPLETE::complement(const Config& config_start,
+                               const int max_timestep_comp)
+{
+  Problem _Q = Problem(P, config_start, P->getConfigGoal(), getRemainedTime(),
+                       max_timestep_comp);
+  _Q.setCancelToken(token);
+  auto comp_solver = getCompSolver(&_Q, comp_solver_type);
+  comp_solver_name = comp_solver->getSolverName();
 
-    info(" ", "elapsed:", getSolverElapsedTime(), ", use",
-         comp_solver->getSolverName(), "to complement the remain");
+  info(" ", "elapsed:", getSolverElapsedTime(), ", use", comp_solver_name,
+       "to complement the remain");
 
-    // solve
-    comp_solver->solve();
+  // solve
+  comp_solver->solve();
+  // failed solvers might return no plan
+  if (!comp_solver->getSolution().empty()) {
     solution += comp_solver->getSolution();
-    if (comp_solver->succeed()) solved = true;
+  }
+  return comp_solver->succeed();
+}
 
-    comp_time_complement = getElapsedTime(t_complement);
+bool PIBT_COMPLETE::complementByRace(const Config& config_start,
+                                     const int max_timestep_comp)
+{
+  // child token, the losers are cancelled without stopping this solver
+  auto token_race = std::make_shared<CancelToken>(token);
+  std::vector<std::unique_ptr<std::mt19937>> MTs;  // each thread has its own
+  std::vector<std::unique_ptr<Problem>> problems;
+  std::vector<std::shared_ptr<Solver>> solvers;
+
+  // setup solvers in advance, options are not thread-safe
+  const int remained_time = getRemainedTime();
+  for (auto solver_type : comp_solver_types) {
+    MTs.push_back(std::make_unique<std::mt19937>((*MT)()));
+    problems.push_back(std::make_unique<Problem>(
+        P, config_start, P->getConfigGoal(), remained_time, max_timestep_comp));
+    problems.back()->setMT(MTs.back().get());
+    problems.back()->setCancelToken(token_race);
+    solvers.push_back(getCompSolver(problems.back().get(), solver_type));
   }
+
+  info(" ", "elapsed:", getSolverElapsedTime(), ", race",
+       solvers.size(), "solvers to complement the remain");
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::shared_ptr<Solver> winner;  // guarded by mtx
+  int finished_num = 0;            // guarded by mtx
+  std::vector<std::thread> threads;
+  for (auto solver : solvers) {
+    threads.emplace_back([&, solver]() {
+      // errors of one solver do not stop the others
+      bool error = false;
+      try {
+        solver->solve();
+      } catch (const MAPFError& e) {
+        warn(std::string("comp-solver failed, ") + e.what());
+        error = true;
+      }
+      std::lock_guard<std::mutex> lock(mtx);
+      ++finished_num;
+      if (!error && solver->succeed() && winner == nullptr) {
+        winner = solver;
+        token_race->cancel();  // cancel the others
+      }
+      cv.notify_all();
+    });
+  }
+
+  // wait for the first success
+  const int solvers_num = solvers.size();
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&] {
+      return winner != nullptr || finished_num == solvers_num;
+    });
+  }
+  token_race->cancel();
+  for (auto& th : threads) th.join();
+
+  if (winner == nullptr) return false;
+  comp_solver_name = winner->getSolverName();
+  info(" ", "elapsed:", getSolverElapsedTime(), ",", comp_solver_name,
+       "wins the race");
+  solution += winner->getSolution();
+  return true;
+}
+
+std::shared_ptr<Solver> PIBT_COMPLETE::getCompSolver(
+    Problem* const _Q, const COMP_SOLVER_TYPE solver_type)
+{
+  std::shared_ptr<Solver> solver;
+  switch (solver_type) {
+    case COMP_SOLVER_TYPE::ICBS:
+      solver = std::make_shared<ICBS>(_Q);
+      break;
+    case COMP_SOLVER_TYPE::ECBS:
+      solver = std::make_shared<ECBS>(_Q);
+      break;
+    default:
+      solver = std::make_shared<PushAndSwap>(_Q);
+      break;
+  }
+
+  // set solver options
+  setSolverOption(solver, option_comp_solver);
+  solver->setDistanceTable((distance_table_p == nullptr) ? &distance_table
+                                                         : distance_table_p);
+  return solver;
+}
+
+bool PIBT_COMPLETE::getCompSolverType(const std::string& s,
+                                      COMP_SOLVER_TYPE& type)
+{
+  if (s == "PushAndSwap") {
+    type = COMP_SOLVER_TYPE::PUSH_AND_SWAP;
+  } else if (s == "ECBS") {
+    type = COMP_SOLVER_TYPE::ECBS;
+  } else if (s == "ICBS") {
+    type = COMP_SOLVER_TYPE::ICBS;
+  } else {
+    return false;
+  }
+  return true;
 }
 
 void PIBT_COMPLETE::setParams(int argc, char* argv[])
@@ -86,20 +188,28 @@ void PIBT_COMPLETE::setParams(int argc, char* argv[])
   optind = 1;  // reset
   int opt, longindex, s_size;
   std::string s, s_tmp;
+  COMP_SOLVER_TYPE comp_solver_type_tmp;
 
   while ((opt = getopt_long(argc, argv, "x:X:", longopts, &longindex)) != -1) {
     switch (opt) {
       case 'x':
-        s = std::string(optarg);
-        if (s == "PushAndSwap") {
-          comp_solver_type = COMP_SOLVER_TYPE::PUSH_AND_SWAP;
-        } else if (s == "ECBS") {
-          comp_solver_type = COMP_SOLVER_TYPE::ECBS;
-        } else if (s == "ICBS") {
-          comp_solver_type = COMP_SOLVER_TYPE::ICBS;
-        } else {
-          warn("solver does not exists, use PushAndSwap");
+        // comma-separated names -> race
+        comp_solver_types.clear();
+        s = std::string(optarg) + ",";
+        s_tmp = "";
+        for (auto c : s) {
+          if (c != ',') {
+            s_tmp += c;
+            continue;
+          }
+          if (getCompSolverType(s_tmp, comp_solver_type_tmp)) {
+            comp_solver_types.push_back(comp_solver_type_tmp);
+          } else {
+            warn("solver " + s_tmp + " does not exists, ignored");
+          }
+          s_tmp = "";
         }
+        if (!comp_solver_types.empty()) comp_solver_type = comp_solver_types[0];
         break;
       case 'X':
         s = std::string(optarg);
@@ -124,7 +234,9 @@ void PIBT_COMPLETE::printHelp()
       << PIBT_COMPLETE::SOLVER_NAME << "\n"
       << "  -x --comp-solver [SOLVER]"
       << "     "
-      << "init solver: { PushAndSwap, ECBS, ICBS }, default: PushAndSwap\n"
+      << "comp solver: { PushAndSwap, ECBS, ICBS }, default: PushAndSwap\n"
+      << "                                "
+      << "comma-separated solvers race, e.g., PushAndSwap,ECBS\n"
 
       << "  -X --option-comp-solver [\"OPTION\"]\n"
       << "                                "
@@ -133,15 +245,13 @@ void PIBT_COMPLETE::printHelp()
       << std::endl;
 }
 
-void PIBT_COMPLETE::makeLog(const std::string& logfile)
+void PIBT_COMPLETE::writeLog(std::ostream& log)
 {
-  std::ofstream log;
-  log.open(logfile, std::ios::out);
   makeLogBasicInfo(log);
 
   // print additional info
   log << "comp_time_complement=" << comp_time_complement << "\n";
+  log << "comp_solver=" << comp_solver_name << "\n";
 
   makeLogSolution(log);
-  log.close();
 }
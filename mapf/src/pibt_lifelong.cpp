@@ -0,0 +1,306 @@
+#include "../include/pibt_lifelong.hpp"
+
+#include <cstring>
+
+#include "../include/mapped_file.hpp"
+
+const std::string PIBT_LIFELONG::SOLVER_NAME = "PIBT_LIFELONG";
+
+PIBT_LIFELONG::PIBT_LIFELONG(Problem* _P)
+    : PIBT(_P),
+      task_file(""),
+      tasks(nullptr),
+      tasks_exhausted(false),
+      horizon(-1),
+      window(-1),
+      timestep(0),
+      tasks_completed(0),
+      step_time_sum(0),
+      step_time_max(0)
+{
+  solver_name = PIBT_LIFELONG::SOLVER_NAME;
+}
+
+void PIBT_LIFELONG::exec()
+{
+  // without BFS of the whole graph, rows are filled on demand
+  distance_table_p = nullptr;
+  distance_table.assign(P->getNum(), std::vector<int>(G->getNodesSize(), NIL));
+  bfs_visited.assign(P->getNum(), {});
+  bfs_head.assign(P->getNum(), 0);
+  for (int i = 0; i < P->getNum(); ++i) {
+    bfs_visited[i].push_back(P->getGoal(i));
+    distance_table[i][P->getGoal(i)->id] = 0;
+  }
+  run();
+}
+
+void PIBT_LIFELONG::run()
+{
+  // open task stream
+  if (task_file == "-") {
+    tasks = &std::cin;
+  } else if (!task_file.empty()) {
+    task_ifs.open(task_file);
+    if (!task_ifs) halt("task file " + task_file + " is not found.");
+    tasks = &task_ifs;
+  } else {
+    createComponents();
+  }
+
+  // 0 -> unlimited
+  const int max_steps = (horizon < 0) ? max_timestep : horizon;
+  // latest configurations kept in the solution
+  const int capacity = (window > 0)       ? window
+                       : (max_steps > 0) ? max_steps + 1
+                                         : DEFAULT_WINDOW;
+
+  // goals of the problem are the first tasks, priorities and lower bounds
+  // refer to their distances
+  for (int i = 0; i < P->getNum(); ++i) lazyDist(i, P->getStart(i));
+  getLowerBoundSOC();
+  initSteps();
+  idle.assign(P->getNum(), false);
+
+  // slots are reused once the buffer is full, no reallocation
+  history.clear();
+  history.reserve(capacity);
+  history.push_back(P->getConfigStart());
+  timestep = 0;
+
+  // main loop
+  while (true) {
+    info(" ", "elapsed:", getSolverElapsedTime(), ", timestep:", timestep,
+         ", completed tasks:", tasks_completed);
+    if ((int)history.size() < capacity) history.emplace_back(P->getNum());
+    const Config& config = history[timestep % capacity];
+    Config& next = history[(timestep + 1) % capacity];
+
+    // the oldest configuration is overwritten
+    auto t_step = Time::now();
+    step(config, next);
+    const double step_time =
+        std::chrono::duration<double, std::micro>(Time::now() - t_step)
+            .count();
+    step_time_sum += step_time;
+    step_time_max = std::max(step_time_max, step_time);
+    ++timestep;
+
+    // reassign goals, reading tasks may block in case of pipes;
+    // agents without tasks stay there
+    int goals_num = 0;  // agents at their goals
+    for (auto& a : agents) {
+      if (a.v_now != a.g) continue;
+      if (!idle[a.id]) {
+        ++tasks_completed;
+        Node* g = getNextTask(&a);
+        if (g == nullptr) {
+          idle[a.id] = true;
+        } else {
+          assignGoal(&a, g);
+          if (g != a.v_now) continue;
+        }
+      }
+      ++goals_num;
+    }
+
+    // all tasks are completed
+    if (goals_num == P->getNum() && tasks_exhausted) break;
+
+    // horizon, lifelong operation has no goal condition
+    if (max_steps > 0 && timestep >= max_steps) break;
+
+    // without horizon, the run is stopped by the time limit
+    if (overCompTime()) break;
+  }
+  solved = !overCompTime() || max_steps == 0;
+
+  // the latest configurations in order
+  solution.clear();
+  for (int t = std::max(0, timestep + 1 - capacity); t <= timestep; ++t) {
+    solution.add(history[t % capacity]);
+  }
+  history.clear();
+}
+
+Node* PIBT_LIFELONG::getNextTask(Agent* a)
+{
+  if (tasks_exhausted) return nullptr;
+
+  // random tasks, other locations reachable from the agent
+  if (tasks == nullptr) {
+    const int c = components[a->v_now->id];
+    if (component_sizes[c] < 2) return nullptr;
+    while (true) {
+      Node* g = G->getNode(getRandomInt(0, G->getNodesSize() - 1, MT));
+      if (g != nullptr && g != a->v_now && components[g->id] == c) return g;
+    }
+  }
+
+  // read one task, blocking in case of pipes
+  std::string line;
+  int x, y;
+  while (getline(*tasks, line)) {
+    if (!line.empty() && line.back() == 0x0d) line.pop_back();
+    const char* s = line.data();
+    const char* e = s + line.size();
+    const char* c = (const char*)std::memchr(s, ',', line.size());
+    if (c == nullptr || !parseUInt(s, c, x) || !parseUInt(c + 1, e, y)) {
+      continue;
+    }
+    if (!G->existNode(x, y)) {
+      halt("task (" + std::to_string(x) + ", " + std::to_string(y) +
+           ") does not exist");
+    }
+    return G->getNode(x, y);
+  }
+  tasks_exhausted = true;
+  return nullptr;
+}
+
+void PIBT_LIFELONG::assignGoal(Agent* a, Node* g)
+{
+  // only nodes visited by the last BFS are cleared
+  auto& dist = distance_table[a->id];
+  for (auto v : bfs_visited[a->id]) dist[v->id] = NIL;
+  bfs_visited[a->id].clear();
+  bfs_visited[a->id].push_back(g);
+  bfs_head[a->id] = 0;
+  dist[g->id] = 0;
+  a->g = g;
+}
+
+int PIBT_LIFELONG::goalDist(Agent* a, Node* v) { return lazyDist(a->id, v); }
+
+void PIBT_LIFELONG::updatePriority(Agent* a)
+{
+  a->elapsed = (a->v_next == a->g && idle[a->id]) ? 0 : a->elapsed + 1;
+}
+
+/*
+ * BFS from the goal is expanded until v is reached, then suspended.
+ * Each goal costs at most one BFS, spread over the queries of the steps,
+ * and limited to nodes nearer to the goal than the agent.
+ */
+int PIBT_LIFELONG::lazyDist(const int i, Node* const v)
+{
+  auto& dist = distance_table[i];
+  auto& visited = bfs_visited[i];
+  auto& head = bfs_head[i];
+  while (dist[v->id] == NIL && head < (int)visited.size()) {
+    Node* n = visited[head++];
+    const int d_n = dist[n->id];
+    for (auto m : n->neighbor) {
+      if (dist[m->id] != NIL) continue;
+      dist[m->id] = d_n + 1;
+      visited.push_back(m);
+    }
+  }
+  // unreachable
+  if (dist[v->id] == NIL) return max_timestep;
+  return dist[v->id];
+}
+
+void PIBT_LIFELONG::createComponents()
+{
+  components.assign(G->getNodesSize(), NIL);
+  component_sizes.clear();
+  for (auto s : G->getV()) {
+    if (components[s->id] != NIL) continue;
+    const int c = component_sizes.size();
+    component_sizes.push_back(0);
+    std::queue<Node*> OPEN;
+    OPEN.push(s);
+    components[s->id] = c;
+    while (!OPEN.empty()) {
+      Node* n = OPEN.front();
+      OPEN.pop();
+      ++component_sizes[c];
+      for (auto m : n->neighbor) {
+        if (components[m->id] != NIL) continue;
+        components[m->id] = c;
+        OPEN.push(m);
+      }
+    }
+  }
+}
+
+double PIBT_LIFELONG::getThroughput() const
+{
+  return (timestep > 0) ? (double)tasks_completed / timestep : 0;
+}
+
+bool PIBT_LIFELONG::validateSolution()
+{
+  return solution.validate(solution.get(0), solution.last());
+}
+
+void PIBT_LIFELONG::writeLog(std::ostream& log)
+{
+  makeLogBasicInfo(log);
+  log << "timesteps=" << timestep << "\n";
+  log << "window_start=" << timestep - solution.getMakespan() << "\n";
+  log << "tasks_completed=" << tasks_completed << "\n";
+  log << "throughput=" << getThroughput() << "\n";
+  log << "step_time_avg_us=" << step_time_sum / std::max(1, timestep) << "\n";
+  log << "step_time_max_us=" << step_time_max << "\n";
+  makeLogSolution(log);
+}
+
+void PIBT_LIFELONG::setParams(int argc, char* argv[])
+{
+  // parse in one pass, getopt permutes argv
+  struct option longopts[] = {
+      {"disable-dist-init", no_argument, 0, 'd'},
+      {"task-file", required_argument, 0, 'f'},
+      {"horizon", required_argument, 0, 'H'},
+      {"window", required_argument, 0, 'w'},
+      {0, 0, 0, 0},
+  };
+  optind = 1;  // reset
+  int opt, longindex;
+  while ((opt = getopt_long(argc, argv, "df:H:w:", longopts, &longindex)) !=
+         -1) {
+    switch (opt) {
+      case 'd':
+        disable_dist_init = true;
+        break;
+      case 'f':
+        task_file = std::string(optarg);
+        break;
+      case 'H':
+        horizon = std::max(0, std::atoi(optarg));
+        break;
+      case 'w':
+        window = std::max(2, std::atoi(optarg));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void PIBT_LIFELONG::printHelp()
+{
+  std::cout << PIBT_LIFELONG::SOLVER_NAME << "\n"
+            << "  -d --disable-dist-init"
+            << "        "
+            << "disable initialization of priorities "
+            << "using distance from starts to goals\n"
+            << "  -f --task-file [FILE_PATH]"
+            << "    "
+            << "goals \"x,y\" assigned on arrivals, '-' for stdin,\n"
+            << "                                "
+            << "random goals without the file\n"
+            << "  -H --horizon [INT]"
+            << "            "
+            << "timesteps to run, 0 for unlimited until the time limit,\n"
+            << "                                "
+            << "default: max timestep of the instance\n"
+            << "  -w --window [INT]"
+            << "             "
+            << "latest configurations kept in the solution,\n"
+            << "                                "
+            << "default: all within the horizon, or "
+            << DEFAULT_WINDOW << " when unlimited" << std::endl;
+}
@@ -0,0 +1,267 @@
+#include "../include/pibt_parallel.hpp"
+
+const std::string PIBT_PARALLEL::SOLVER_NAME = "PIBT_PARALLEL";
+
+PIBT_PARALLEL::PIBT_PARALLEL(Problem* _P)
+    : PIBT(_P),
+      regions_num(4),
+      threads_num(std::max(1, (int)std::thread::hardware_concurrency())),
+      generation(0),
+      done_num(0),
+      terminated(false),
+      next_region(0)
+{
+  solver_name = PIBT_PARALLEL::SOLVER_NAME;
+}
+
+PIBT_PARALLEL::~PIBT_PARALLEL()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    terminated = true;
+  }
+  cv_start.notify_all();
+  for (auto& th : workers) th.join();
+}
+
+void PIBT_PARALLEL::setupRegions()
+{
+  // vertical strips with almost the same number of nodes
+  Grid* grid = reinterpret_cast<Grid*>(G);
+  const int width = grid->getWidth();
+  const int nodes_size = G->getNodesSize();
+  std::vector<int> column_size(width, 0);
+  int total = 0;
+  for (int i = 0; i < nodes_size; ++i) {
+    Node* v = G->getNode(i);
+    if (v == nullptr) continue;
+    ++column_size[v->pos.x];
+    ++total;
+  }
+  std::vector<int> column_region(width, 0);
+  for (int x = 0, cnt = 0; x < width; ++x) {
+    column_region[x] =
+        std::min(regions_num - 1, (int)((long)cnt * regions_num / total));
+    cnt += column_size[x];
+  }
+
+  region_ids.assign(nodes_size, -1);
+  for (int i = 0; i < nodes_size; ++i) {
+    Node* v = G->getNode(i);
+    if (v != nullptr) region_ids[i] = column_region[v->pos.x];
+  }
+  interior.assign(nodes_size, false);
+  for (int i = 0; i < nodes_size; ++i) {
+    Node* v = G->getNode(i);
+    if (v == nullptr) continue;
+    interior[i] = std::all_of(v->neighbor.begin(), v->neighbor.end(),
+                              [&](Node* u) { return region_ids[u->id] == region_ids[i]; });
+  }
+
+  // buffers and generators, seeded in order for reproducibility
+  regions.resize(regions_num);
+  for (auto& r : regions) {
+    r.roots.reserve(P->getNum());
+    r.MT.seed((*MT)());
+  }
+
+  // workers
+  const int workers_num = std::min(threads_num, regions_num) - 1;
+  for (int i = 0; i < workers_num; ++i) {
+    workers.emplace_back(&PIBT_PARALLEL::work, this);
+  }
+}
+
+void PIBT_PARALLEL::planNextLocations()
+{
+  if (regions.empty()) setupRegions();
+
+  // agents are taken in the order, priorities are kept across the phases
+  for (auto a : order) {
+    if (interior[a->v_now->id]) {
+      regions[region_ids[a->v_now->id]].roots.push_back(a);
+    } else {
+      planRegionsConcurrently();
+      // agents at boundaries are planned by the original PIBT
+      if (a->v_next == nullptr) PIBT::funcPIBT(a);
+    }
+  }
+  planRegionsConcurrently();
+}
+
+void PIBT_PARALLEL::planRegionsConcurrently()
+{
+  int active_num = 0;
+  for (auto& r : regions) active_num += !r.roots.empty();
+  next_region = 0;
+  if (active_num > 1 && !workers.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      done_num = 0;
+      ++generation;
+    }
+    cv_start.notify_all();
+    planRegions();
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&] { return done_num == (int)workers.size(); });
+  } else if (active_num > 0) {
+    planRegions();
+  }
+  for (auto& r : regions) r.roots.clear();
+}
+
+void PIBT_PARALLEL::work()
+{
+  int current = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_start.wait(lock, [&] { return terminated || generation != current; });
+      if (terminated) return;
+      current = generation;
+    }
+    planRegions();
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      ++done_num;
+    }
+    cv_done.notify_one();
+  }
+}
+
+void PIBT_PARALLEL::planRegions()
+{
+  for (int k = next_region++; k < regions_num; k = next_region++) {
+    for (auto a : regions[k].roots) {
+      if (a->v_next == nullptr) funcPIBT(a, k);
+    }
+  }
+}
+
+/*
+ * nodes and agents in region k are only used,
+ * so regions are planned without synchronization
+ */
+bool PIBT_PARALLEL::funcPIBT(Agent* ai, const int k)
+{
+  // decide next node
+  Node* v = planOneStep(ai, k);
+  while (v != nullptr) {
+    auto aj = occupied_now[v->id];
+    if (aj != nullptr) {  // someone occupies v
+      // avoid itself && allow rotations
+      if (aj != ai && aj->v_next == nullptr) {
+        // do priority inheritance and backtracking
+        if (!funcPIBT(aj, k)) {
+          // replan
+          v = planOneStep(ai, k);
+          continue;
+        }
+      }
+    }
+    // success to plan next one step
+    return true;
+  }
+  // failed to secure node, cope stuck
+  occupied_next[ai->v_now->id] = ai;
+  ai->v_next = ai->v_now;
+  return false;
+}
+
+Node* PIBT_PARALLEL::planOneStep(Agent* a, const int k)
+{
+  Node* v = chooseNode(a, k);
+  if (v != nullptr) {
+    // update reservation
+    occupied_next[v->id] = a;
+    a->v_next = v;
+  }
+  return v;
+}
+
+// no candidate node -> return nullptr
+Node* PIBT_PARALLEL::chooseNode(Agent* a, const int k)
+{
+  // candidates in the region
+  auto& C = regions[k].C;
+  C.clear();
+  for (auto u : a->v_now->neighbor) {
+    if (region_ids[u->id] == k) C.push_back(u);
+  }
+  C.push_back(a->v_now);
+
+  // randomize
+  std::shuffle(C.begin(), C.end(), regions[k].MT);
+
+  // desired node
+  Node* v = nullptr;
+
+  // pickup one node
+  for (auto u : C) {
+    // avoid vertex conflict
+    if (occupied_next[u->id] != nullptr) continue;
+    // avoid swap conflict
+    auto a_j = occupied_now[u->id];
+    if (a_j != nullptr && a_j->v_next == a->v_now) continue;
+
+    // goal exists -> return immediately
+    if (u == a->g) return u;
+
+    // determine the next node
+    if (v == nullptr) {
+      v = u;
+    } else {
+      int c_v = pathDist(a->id, v);
+      int c_u = pathDist(a->id, u);
+      if ((c_u < c_v) || (c_u == c_v && occupied_now[v->id] != nullptr &&
+                          occupied_now[u->id] == nullptr)) {
+        v = u;
+      }
+    }
+  }
+
+  return v;
+}
+
+void PIBT_PARALLEL::setParams(int argc, char* argv[])
+{
+  // parse in one pass, getopt permutes argv
+  struct option longopts[] = {
+      {"disable-dist-init", no_argument, 0, 'd'},
+      {"regions", required_argument, 0, 'r'},
+      {"threads", required_argument, 0, 'j'},
+      {0, 0, 0, 0},
+  };
+  optind = 1;  // reset
+  int opt, longindex;
+  while ((opt = getopt_long(argc, argv, "dr:j:", longopts, &longindex)) != -1) {
+    switch (opt) {
+      case 'd':
+        disable_dist_init = true;
+        break;
+      case 'r':
+        regions_num = std::max(1, std::atoi(optarg));
+        break;
+      case 'j':
+        threads_num = std::max(1, std::atoi(optarg));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void PIBT_PARALLEL::printHelp()
+{
+  std::cout << PIBT_PARALLEL::SOLVER_NAME << "\n"
+            << "  -d --disable-dist-init"
+            << "        "
+            << "disable initialization of priorities "
+            << "using distance from starts to goals\n"
+            << "  -r --regions [INT]"
+            << "            "
+            << "number of regions, the plan depends on it\n"
+            << "  -j --threads [INT]"
+            << "            "
+            << "number of threads" << std::endl;
+}
@@ -36,12 +36,29 @@ Node* Plan::last(const int i) const
   return configs[getMakespan()][i];
 }
 
-void Plan::clear() { configs.clear(); }
+void Plan::clear()
+{
+  configs.clear();
+  costs.clear();
+  soc = 0;
+}
 
 void Plan::add(const Config& c)
 {
-  if (!configs.empty() && configs.at(0).size() != c.size()) {
-    halt("invalid operation");
+  if (configs.empty()) {
+    costs.assign(c.size(), 0);
+    soc = 0;
+  } else {
+    if (configs.at(0).size() != c.size()) halt("invalid operation");
+    // agents moving at the new timestep
+    const Config& c_last = configs.back();
+    const int t = configs.size();
+    const int num_agents = c.size();
+    for (int i = 0; i < num_agents; ++i) {
+      if (c[i] == c_last[i]) continue;
+      soc += t - costs[i];
+      costs[i] = t;
+    }
   }
   configs.push_back(c);
 }
@@ -54,22 +71,12 @@ int Plan::getMakespan() const { return size() - 1; }
 
 int Plan::getPathCost(const int i) const
 {
-  const int makespan = getMakespan();
-  const Node* g = get(makespan, i);
-  int c = makespan;
-  while (c > 0 && get(c - 1, i) == g) --c;
-  return c;
+  if (empty()) halt("invalid operation");
+  if (!(0 <= i && i < (int)costs.size())) halt("invalid agent id");
+  return costs[i];
 }
 
-int Plan::getSOC() const
-{
-  int makespan = getMakespan();
-  if (makespan <= 0) return 0;
-  int num_agents = get(0).size();
-  int soc = 0;
-  for (int i = 0; i < num_agents; ++i) soc += getPathCost(i);
-  return soc;
-}
+int Plan::getSOC() const { return soc; }
 
 Plan Plan::operator+(const Plan& other) const
 {
@@ -83,8 +90,7 @@ Plan Plan::operator+(const Plan& other) const
     if (c1[i] != c2[i]) halt("invalid operation.");
   }
   // merge
-  Plan new_plan;
-  new_plan.configs = configs;
+  Plan new_plan = *this;
   for (int t = 1; t < other.size(); ++t) new_plan.add(other.get(t));
   return new_plan;
 }
@@ -92,7 +98,7 @@ Plan Plan::operator+(const Plan& other) const
 void Plan::operator+=(const Plan& other)
 {
   if (configs.empty()) {
-    configs = other.configs;
+    *this = other;
     return;
   }
   // check validity
@@ -175,9 +181,7 @@ int Plan::getMaxConstraintTime(const int id, Problem* P) const
 
 void Plan::halt(const std::string& msg) const
 {
-  std::cout << "error@Plan: " << msg << std::endl;
-  this->~Plan();
-  std::exit(1);
+  throw MAPFError("error@Plan: " + msg);
 }
 
 void Plan::warn(const std::string& msg) const
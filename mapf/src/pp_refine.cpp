@@ -0,0 +1,134 @@
+#include "../include/pp_refine.hpp"
+
+const std::string PP_REFINE::SOLVER_NAME = "PP_REFINE";
+
+PP_REFINE::PP_REFINE(Problem* _P, const Plan& _old_plan,
+                     const ReservationTable* _reserved_p,
+                     const std::vector<int>& _ignored)
+    : Solver(_P),
+      ub_soc(_old_plan.getSOC()),
+      reserved_p(_reserved_p),
+      reserved_ignored(_ignored),
+      max_trials(DEFAULT_MAX_TRIALS)
+{
+  solver_name = SOLVER_NAME;
+  table_goals.resize(G->getNodesSize(), false);
+  for (auto v : P->getConfigGoal()) table_goals[v->id] = true;
+}
+
+void PP_REFINE::run()
+{
+  std::vector<int> order(P->getNum());
+  std::iota(order.begin(), order.end(), 0);
+
+  int best_soc = ub_soc;
+  for (int k = 0; k < max_trials && !overCompTime(); ++k) {
+    std::shuffle(order.begin(), order.end(), *MT);
+    const Paths paths = getPathsByOrder(order, best_soc - 1);
+    if (paths.empty()) continue;
+    best_soc = paths.getSOC();
+    solution = pathsToPlan(paths);
+    solved = true;
+    info(" ", "elapsed:", getSolverElapsedTime(), ", trial:", k,
+         ", soc:", ub_soc, "->", best_soc);
+  }
+}
+
+Paths PP_REFINE::getPathsByOrder(const std::vector<int>& order,
+                                 const int soc_limit)
+{
+  // remained lower bound of sum-of-costs
+  int lb_soc = 0;
+  for (auto i : order) lb_soc += pathDist(i);
+
+  Paths paths(P->getNum());
+  ReservationTable planned;
+  int soc = 0;
+  for (auto i : order) {
+    lb_soc -= pathDist(i);
+    const auto path = getPath(i, planned, soc_limit - soc - lb_soc);
+    if (path.empty()) return Paths();
+    soc += getPathCost(path);
+    planned.add(i, path);
+    paths.insert(i, path);
+  }
+  return paths;
+}
+
+Path PP_REFINE::getPath(const int id, const ReservationTable& planned,
+                        const int cost_limit)
+{
+  Node* s = P->getStart(id);
+  Node* g = P->getGoal(id);
+  if (pathDist(id) > cost_limit) return {};
+
+  // someone uses the goal until this timestep, NIL -> no one
+  const int max_constraint_time =
+      std::max(reserved_p->getLastReservedTime(g, reserved_ignored),
+               planned.getLastReservedTime(g));
+  if (max_constraint_time + 1 > cost_limit) return {};
+
+  AstarHeuristics fValue = [&](AstarNode* n) {
+    return std::max(max_constraint_time + 1, n->g + pathDist(id, n->v));
+  };
+
+  const int t_others = reserved_p->getMakespan() + 1;
+  auto isOthersGoal = [&](Node* v) {
+    if (v == g) return false;
+    if (table_goals[v->id]) return true;
+    return reserved_p->get(t_others, v, reserved_ignored) !=
+           ReservationTable::NIL;
+  };
+
+  CompareAstarNode compare = [&](AstarNode* a, AstarNode* b) {
+    if (a->f != b->f) return a->f > b->f;
+    // avoid goal locations of others
+    if (isOthersGoal(a->v)) return true;
+    if (isOthersGoal(b->v)) return false;
+    if (a->g != b->g) return a->g < b->g;
+    return false;
+  };
+
+  CheckAstarFin checkAstarFin = [&](AstarNode* n) {
+    return n->v == g && n->g > max_constraint_time;
+  };
+
+  CheckInvalidAstarNode checkInvalidAstarNode = [&](AstarNode* m) {
+    // budget of sum-of-costs
+    if (m->f > cost_limit || m->g > max_timestep) return true;
+    if (reserved_p->isConflicted(m->p->v, m->v, m->g, reserved_ignored))
+      return true;
+    return planned.isConflicted(m->p->v, m->v, m->g);
+  };
+
+  return getPathBySpaceTimeAstar(s, g, fValue, compare, checkAstarFin,
+                                 checkInvalidAstarNode, -1, token.get());
+}
+
+void PP_REFINE::setParams(int argc, char* argv[])
+{
+  struct option longopts[] = {
+      {"max-trials", required_argument, 0, 'n'},
+      {0, 0, 0, 0},
+  };
+  optind = 1;  // reset
+  int opt, longindex;
+
+  while ((opt = getopt_long(argc, argv, "n:", longopts, &longindex)) != -1) {
+    switch (opt) {
+      case 'n':
+        max_trials = std::max(1, std::atoi(optarg));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void PP_REFINE::printHelp()
+{
+  std::cout << SOLVER_NAME << "\n"
+            << "  -n --max-trials [INT]         "
+            << "number of random orders, default: " << DEFAULT_MAX_TRIALS
+            << std::endl;
+}
@@ -1,106 +1,134 @@
 #include "../include/problem.hpp"
 
+#include <cstring>
 #include <fstream>
-#include <regex>
 
+#include "../include/mapped_file.hpp"
+#include "../include/scenario.hpp"
 #include "../include/util.hpp"
 
-Problem::Problem(const std::string& _instance)
-    : instance(_instance), instance_initialized(true)
+Problem::Problem(const std::string& _instance) : Problem(_instance, nullptr)
 {
-  // read instance file
-  std::ifstream file(instance);
-  if (!file) halt("file " + instance + " is not found.");
-
-  std::string line;
-  std::smatch results;
-  std::regex r_comment = std::regex(R"(#.+)");
-  std::regex r_map = std::regex(R"(map_file=(.+))");
-  std::regex r_agents = std::regex(R"(agents=(\d+))");
-  std::regex r_seed = std::regex(R"(seed=(\d+))");
-  std::regex r_random_problem = std::regex(R"(random_problem=(\d+))");
-  std::regex r_well_formed = std::regex(R"(well_formed=(\d+))");
-  std::regex r_max_timestep = std::regex(R"(max_timestep=(\d+))");
-  std::regex r_max_comp_time = std::regex(R"(max_comp_time=(\d+))");
-  std::regex r_sg = std::regex(R"((\d+),(\d+),(\d+),(\d+))");
+}
+
+Problem::Problem(const std::string& _instance, GraphTable* _graphs)
+    : instance(_instance),
+      G(nullptr),
+      MT(nullptr),
+      num_agents(0),
+      max_timestep(0),
+      max_comp_time(0),
+      cancel_token(std::make_shared<CancelToken>()),
+      instance_initialized(true),
+      graph_shared(_graphs != nullptr)
+{
+  // owned until the end, released when halt throws
+  std::unique_ptr<Graph> G_owned;
+  std::unique_ptr<std::mt19937> MT_owned;
+
+  // read instance file, single pass over the mapped buffer
+  MappedFile file(instance);
+  if (!file.isOpen()) halt("file " + instance + " is not found.");
 
   bool read_scen = true;
   bool well_formed = false;
-  while (getline(file, line)) {
+  int v;
+  const char* const end = file.data() + file.size();
+  for (const char *l = file.data(), *e = l; l < end; l = e + 1) {
+    e = static_cast<const char*>(std::memchr(l, '\n', end - l));
+    if (e == nullptr) e = end;
+    const char* line_end = e;
     // for CRLF coding
-    if (*(line.end() - 1) == 0x0d) line.pop_back();
+    if (line_end > l && *(line_end - 1) == 0x0d) --line_end;
+    if (line_end == l) continue;
+
     // comment
-    if (std::regex_match(line, results, r_comment)) {
-      continue;
-    }
-    // read map
-    if (std::regex_match(line, results, r_map)) {
-      G = new Grid(results[1].str());
-      continue;
-    }
-    // set agent num
-    if (std::regex_match(line, results, r_agents)) {
-      num_agents = std::stoi(results[1].str());
-      continue;
-    }
-    // set random seed
-    if (std::regex_match(line, results, r_seed)) {
-      MT = new std::mt19937(std::stoi(results[1].str()));
-      continue;
-    }
-    // skip reading initial/goal nodes
-    if (std::regex_match(line, results, r_random_problem)) {
-      if (std::stoi(results[1].str())) {
-        read_scen = false;
-        config_s.clear();
-        config_g.clear();
+    if (*l == '#') continue;
+
+    // key=value
+    const char* eq =
+        static_cast<const char*>(std::memchr(l, '=', line_end - l));
+    if (eq != nullptr) {
+      const std::string key(l, eq);
+      const char* val = eq + 1;
+      if (key == "map_file") {
+        // read map
+        if (val == line_end) continue;
+        const std::string map_file(val, line_end);
+        if (_graphs == nullptr) {
+          G_owned = std::make_unique<Grid>(map_file);
+          G = G_owned.get();
+        } else {
+          G = getGraph(map_file, _graphs);
+        }
+      } else if (!parseUInt(val, line_end, v)) {
+        continue;
+      } else if (key == "agents") {
+        // set agent num
+        num_agents = v;
+      } else if (key == "seed") {
+        // set random seed
+        MT_owned = std::make_unique<std::mt19937>(v);
+        MT = MT_owned.get();
+      } else if (key == "random_problem") {
+        // skip reading initial/goal nodes
+        if (v) {
+          read_scen = false;
+          config_s.clear();
+          config_g.clear();
+        }
+      } else if (key == "well_formed") {
+        if (v) well_formed = true;
+      } else if (key == "max_timestep") {
+        // set max timestep
+        max_timestep = v;
+      } else if (key == "max_comp_time") {
+        // set max computation time
+        max_comp_time = v;
       }
       continue;
     }
-    //
-    if (std::regex_match(line, results, r_well_formed)) {
-      if (std::stoi(results[1].str())) well_formed = true;
-      continue;
+
+    // read initial/goal nodes, "x_s,y_s,x_g,y_g"
+    if (!read_scen || (int)config_s.size() >= num_agents) continue;
+    int xy[4];
+    const char* p = l;
+    bool matched = true;
+    for (int k = 0; k < 4 && matched; ++k) {
+      const char* q = (k < 3) ? static_cast<const char*>(
+                                    std::memchr(p, ',', line_end - p))
+                              : line_end;
+      matched = (q != nullptr) && parseUInt(p, q, xy[k]);
+      if (matched) p = q + 1;
     }
-    // set max timestep
-    if (std::regex_match(line, results, r_max_timestep)) {
-      max_timestep = std::stoi(results[1].str());
-      continue;
+    if (!matched) continue;
+    if (G == nullptr) halt("map_file is not specified");
+    const int x_s = xy[0], y_s = xy[1], x_g = xy[2], y_g = xy[3];
+    if (!G->existNode(x_s, y_s)) {
+      halt("start node (" + std::to_string(x_s) + ", " + std::to_string(y_s) +
+           ") does not exist, invalid scenario");
     }
-    // set max computation time
-    if (std::regex_match(line, results, r_max_comp_time)) {
-      max_comp_time = std::stoi(results[1].str());
-      continue;
+    if (!G->existNode(x_g, y_g)) {
+      halt("goal node (" + std::to_string(x_g) + ", " + std::to_string(y_g) +
+           ") does not exist, invalid scenario");
     }
-    // read initial/goal nodes
-    if (std::regex_match(line, results, r_sg) && read_scen &&
-        (int)config_s.size() < num_agents) {
-      int x_s = std::stoi(results[1].str());
-      int y_s = std::stoi(results[2].str());
-      int x_g = std::stoi(results[3].str());
-      int y_g = std::stoi(results[4].str());
-      if (!G->existNode(x_s, y_s)) {
-        halt("start node (" + std::to_string(x_s) + ", " + std::to_string(y_s) +
-             ") does not exist, invalid scenario");
-      }
-      if (!G->existNode(x_g, y_g)) {
-        halt("goal node (" + std::to_string(x_g) + ", " + std::to_string(y_g) +
-             ") does not exist, invalid scenario");
-      }
 
-      Node* s = G->getNode(x_s, y_s);
-      Node* g = G->getNode(x_g, y_g);
-      config_s.push_back(s);
-      config_g.push_back(g);
-    }
+    Node* s = G->getNode(x_s, y_s);
+    Node* g = G->getNode(x_g, y_g);
+    config_s.push_back(s);
+    config_g.push_back(g);
   }
 
   // set default value not identified params
-  if (MT == nullptr) MT = new std::mt19937(DEFAULT_SEED);
+  if (MT == nullptr) {
+    MT_owned = std::make_unique<std::mt19937>(DEFAULT_SEED);
+    MT = MT_owned.get();
+  }
   if (max_timestep == 0) max_timestep = DEFAULT_MAX_TIMESTEP;
   if (max_comp_time == 0) max_comp_time = DEFAULT_MAX_COMP_TIME;
 
   // check starts/goals
+  if (G == nullptr) halt("map_file is not specified");
   if (num_agents <= 0) halt("invalid number of agents");
   const int config_s_size = config_s.size();
   if (!config_s.empty() && num_agents > config_s_size) {
@@ -117,6 +145,81 @@ Problem::Problem(const std::string& _instance)
   // trimming
   config_s.resize(num_agents);
   config_g.resize(num_agents);
+
+  // deleted by the destructor
+  G_owned.release();
+  MT_owned.release();
+}
+
+Problem::Problem(const Scenario& scen, int _num_agents, GraphTable* _graphs,
+                 int _max_comp_time, int _max_timestep, int _seed)
+    : instance(scen.getFileName()),
+      G(nullptr),
+      MT(nullptr),
+      num_agents(_num_agents),
+      max_timestep(_max_timestep),
+      max_comp_time(_max_comp_time),
+      cancel_token(std::make_shared<CancelToken>()),
+      instance_initialized(true),
+      graph_shared(_graphs != nullptr)
+{
+  if (num_agents <= 0 || num_agents > scen.getSize()) {
+    halt("invalid number of agents, " + scen.getFileName() + " has " +
+         std::to_string(scen.getSize()) + " agents");
+  }
+
+  // owned until the end, released when halt throws
+  std::unique_ptr<Graph> G_owned;
+
+  // read map
+  if (_graphs == nullptr) {
+    G_owned = std::make_unique<Grid>(scen.getMapFileName());
+    G = G_owned.get();
+  } else {
+    G = getGraph(scen.getMapFileName(), _graphs);
+  }
+  Grid* grid = reinterpret_cast<Grid*>(G);
+  if (grid->getWidth() != scen.getWidth() ||
+      grid->getHeight() != scen.getHeight()) {
+    halt("size of " + scen.getMapFileName() + " differs from the scenario");
+  }
+
+  // initial/goal nodes
+  for (int i = 0; i < num_agents; ++i) {
+    auto& entry = scen.getEntry(i);
+    if (!G->existNode(entry.x_s, entry.y_s) ||
+        !G->existNode(entry.x_g, entry.y_g)) {
+      halt("start or goal of agent " + std::to_string(i) +
+           " does not exist, invalid scenario");
+    }
+    config_s.push_back(G->getNode(entry.x_s, entry.y_s));
+    config_g.push_back(G->getNode(entry.x_g, entry.y_g));
+  }
+
+  MT = new std::mt19937(_seed);
+  // deleted by the destructor
+  G_owned.release();
+}
+
+Problem::Problem(Graph* _G, const Config& _config_s, const Config& _config_g,
+                 int _max_comp_time, int _max_timestep, int _seed)
+    : instance(""),
+      G(_G),
+      MT(nullptr),
+      config_s(_config_s),
+      config_g(_config_g),
+      num_agents(_config_s.size()),
+      max_timestep(_max_timestep),
+      max_comp_time(_max_comp_time),
+      cancel_token(std::make_shared<CancelToken>()),
+      instance_initialized(true),
+      graph_shared(true)
+{
+  if (num_agents <= 0) halt("invalid number of agents");
+  if (config_s.size() != config_g.size()) {
+    halt("numbers of starts and goals are different");
+  }
+  MT = new std::mt19937(_seed);
 }
 
 Problem::Problem(Problem* P, Config _config_s, Config _config_g,
@@ -125,10 +228,12 @@ Problem::Problem(Problem* P, Config _config_s, Config _config_g,
       MT(P->getMT()),
       config_s(_config_s),
       config_g(_config_g),
-      num_agents(P->getNum()),
+      num_agents(_config_s.size()),
       max_timestep(_max_timestep),
       max_comp_time(_max_comp_time),
-      instance_initialized(false)
+      cancel_token(P->cancel_token),
+      instance_initialized(false),
+      graph_shared(true)
 {
 }
 
@@ -140,18 +245,35 @@ Problem::Problem(Problem* P, int _max_comp_time)
       num_agents(P->getNum()),
       max_timestep(P->getMaxTimestep()),
       max_comp_time(_max_comp_time),
-      instance_initialized(false)
+      cancel_token(P->cancel_token),
+      instance_initialized(false),
+      graph_shared(true)
 {
 }
 
 Problem::~Problem()
 {
   if (instance_initialized) {
-    if (G != nullptr) delete G;
+    if (G != nullptr && !graph_shared) delete G;
     if (MT != nullptr) delete MT;
   }
 }
 
+Graph* Problem::getGraph(const std::string& map_file, GraphTable* graphs)
+{
+  auto& graph = (*graphs)[map_file];
+  if (graph == nullptr) {
+    // Grid terminates the process when the map is not found
+    if (!std::ifstream(map_file) &&
+        !std::ifstream(std::string(_MAPDIR_) + map_file)) {
+      graphs->erase(map_file);
+      throw MAPFError("error@Problem: map " + map_file + " is not found.");
+    }
+    graph = std::make_unique<Grid>(map_file);
+  }
+  return graph.get();
+}
+
 Node* Problem::getStart(int i) const
 {
   if (!(0 <= i && i < (int)config_s.size())) halt("invalid index");
@@ -259,9 +381,7 @@ void Problem::setWellFormedInstance()
 // I know that using "const" is something wired...
 void Problem::halt(const std::string& msg) const
 {
-  std::cout << "error@Problem: " << msg << std::endl;
-  this->~Problem();
-  std::exit(1);
+  throw MAPFError("error@Problem: " + msg);
 }
 
 void Problem::warn(const std::string& msg) const
@@ -12,14 +12,15 @@ PushAndSwap::PushAndSwap(Problem* _P)
 
 void PushAndSwap::run()
 {
-  solution.add(P->getConfigStart());
-
-  // occupancy
-  std::vector<int> occupied_now(G->getNodesSize(), NIL);
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[solution.last(i)->id] = i;
+  // initial locations
+  moves.clear();
+  config_now = P->getConfigStart();
+  occupied_now.assign(G->getNodesSize(), NIL);
+  for (int i = 0; i < P->getNum(); ++i) occupied_now[config_now[i]->id] = i;
 
   // pre-processing
-  findNodesWithManyNeighbors();
+  bfs_parents.assign(G->getNodesSize(), NIL);
+  bfs_queue.clear();
 
   // nodes with agents at goals
   Nodes U;
@@ -37,32 +38,37 @@ void PushAndSwap::run()
     const int i = ids[j];
     info(" ", "elapsed:", getSolverElapsedTime(),
          ", agent-" + std::to_string(i), "starts planning",
-         ", makespan:", solution.getMakespan(), ", progress:", j + 1, "/",
+         ", makespan:", moves.size(), ", progress:", j + 1, "/",
          P->getNum());
-    while (solution.last(i) != P->getGoal(i)) {
-      if (!push(solution, i, U, occupied_now)) {
-        info("   ", "swap required, timestep=", solution.getMakespan());
-        if (!swap(solution, i, U, occupied_now)) {
+    while (config_now[i] != P->getGoal(i)) {
+      if (!push(i, U)) {
+        info("   ", "swap required, timestep=", moves.size());
+        if (!swap(i, U)) {
+          solution = getPlan();
           return;  // failed
         }
       }
     }
-    U.push_back(solution.last(i));
+    U.push_back(config_now[i]);
 
     // check limitation
-    if (overCompTime()) return;
+    if (overCompTime()) {
+      solution = getPlan();
+      return;
+    }
   }
 
   // compress solution
   if (flg_compress) {
     info("  ---");
     info(" ", "elapsed:", getSolverElapsedTime(), ", compress solution",
-         ", soc (before):", solution.getSOC(),
-         ", makespan (before):", solution.getMakespan());
-    solution = compress(solution);
+         ", makespan (before):", moves.size());
+    solution = compress();
     info(" ", "elapsed:", getSolverElapsedTime(), ", finish compression",
          ", soc (after):", solution.getSOC(),
-         ", makespan (before):", solution.getMakespan());
+         ", makespan (after):", solution.getMakespan());
+  } else {
+    solution = getPlan();
   }
 
   // check makespan
@@ -73,95 +79,65 @@ void PushAndSwap::run()
   }
 }
 
-bool PushAndSwap::push(Plan& plan, const int id, Nodes& U,
-                       std::vector<int>& occupied_now)
+bool PushAndSwap::push(const int id, Nodes& U)
 {
-  if (plan.last(id) == P->getGoal(id)) return true;
+  if (config_now[id] == P->getGoal(id)) return true;
 
   // create shortest path
-  Path p_star = getShortestPath(id, plan.last(id), occupied_now);
-  p_star.erase(p_star.begin());
-  if (p_star.empty()) return true;  // for safety
+  const Path p_star = getShortestPath(id, config_now[id]);
+  const int p_size = p_star.size();
+  if (p_size <= 1) return true;  // for safety
 
-  Node* v = p_star[0];
-  while (plan.last(id) != P->getGoal(id)) {
+  int k = 1;
+  Node* v = p_star[k];
+  while (config_now[id] != P->getGoal(id)) {
     while (occupied_now[v->id] == NIL) {
-      updatePlan(id, v, plan, occupied_now);
-      p_star.erase(p_star.begin());
-      if (p_star.empty()) return true;
-      v = p_star[0];
+      updatePlan(id, v);
+      if (++k == p_size) return true;
+      v = p_star[k];
     }
     Nodes obs = U;
-    obs.push_back(plan.last(id));
-    if (!pushTowardEmptyNode(v, plan, occupied_now, obs)) return false;
+    obs.push_back(config_now[id]);
+    if (!pushTowardEmptyNode(v, obs)) return false;
   }
 
   return true;
 }
 
-bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
-                       std::vector<int>& occupied_now)
+bool PushAndSwap::swap(const int r, Nodes& U)
 {
-  auto p_star = getShortestPath(r, plan.last(r), occupied_now);
+  auto p_star = getShortestPath(r, config_now[r]);
   if (p_star.size() <= 1) return true;  // for safety
   const int s = occupied_now[p_star[1]->id];
   if (s == NIL) return true;  // for safety
 
-  const Config c_before = plan.last();
+  const Config c_before = config_now;
 
   bool succcess = false;
-  Nodes swap_verticies = nodes_with_many_neighbors;
-  // sort, make swap operation easy
-  {
-    Node* v = p_star[0];
-    std::sort(swap_verticies.begin(), swap_verticies.end(),
-              [v](Node* a, Node* b) {
-                return v->manhattanDist(a) < v->manhattanDist(b);
-              });
-  }
-
-  Plan tmp_plan;
-  while (!swap_verticies.empty() && !succcess) {
-    Node* v = swap_verticies[0];
-    swap_verticies.erase(swap_verticies.begin());
-    auto p = G->getPath(plan.last(r), v, false);  // no cache
-    tmp_plan.clear();
-    auto tmp_occupied_now = occupied_now;
-    tmp_plan.add(plan.last());
-    if (v == plan.last(r) || multiPush(tmp_plan, r, s, p, tmp_occupied_now)) {
-      if (clear(tmp_plan, v, r, s, tmp_occupied_now)) succcess = true;
+  // nearer swap vertices first, make swap operation easy
+  initSwapVertexSearch(p_star[0]);
+
+  // moves after tmp_start form the temporal plan
+  const int tmp_start = moves.size();
+  for (Node* v = getNextSwapVertex(); v != nullptr; v = getNextSwapVertex()) {
+    if (trySwapVertex(v, r, s)) {
+      succcess = true;
+      break;
     }
   }
   if (!succcess) return false;
-
-  // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = NIL;
-  // update plan
-  plan += tmp_plan;
-  // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = i;
-
-  executeSwap(plan, r, s, occupied_now);
-  Plan reversed_tmp_plan;
-  {
-    const int makespan = tmp_plan.getMakespan();
-    for (int t = makespan; t >= 0; --t) {
-      auto c = tmp_plan.get(t);
-      auto tmp = c[r];
-      c[r] = c[s];
-      c[s] = tmp;
-      reversed_tmp_plan.add(c);
-    }
+  const int tmp_end = moves.size();
+
+  executeSwap(r, s);
+  // reverse the temporal plan while exchanging r and s
+  for (int k = tmp_end - 1; k >= tmp_start; --k) {
+    const Move m = moves[k];
+    const int id = (m.id == r) ? s : (m.id == s) ? r : m.id;
+    updatePlan(id, m.from);
   }
-  // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = NIL;
-  // update plan
-  plan += reversed_tmp_plan;
-  // update occupancy
-  for (int i = 0; i < P->getNum(); ++i) occupied_now[plan.last(i)->id] = i;
 
   // validation
-  const Config c_after = plan.last();
+  const Config& c_after = config_now;
   for (int i = 0; i < P->getNum(); ++i) {
     if ((i == s && c_after[s] != c_before[r]) ||
         (i == r && c_after[r] != c_before[s]) ||
@@ -173,71 +149,84 @@ bool PushAndSwap::swap(Plan& plan, const int r, Nodes& U,
                   " swap locations " + std::to_string(c_before[r]->id) + ", " +
                   std::to_string(c_before[s]->id));
 
-  if (inArray(P->getGoal(s), U)) return resolve(plan, r, s, U, occupied_now);
+  if (inArray(P->getGoal(s), U)) return resolve(r, s, U);
 
   return true;
 }
 
-bool PushAndSwap::resolve(Plan& plan, const int r, const int s, Nodes& U,
-                          std::vector<int>& occupied_now)
+bool PushAndSwap::trySwapVertex(Node* v, const int r, const int s)
+{
+  const int size = moves.size();
+  if (v == config_now[r] || multiPush(r, s, getPathToSwapVertex(v))) {
+    if (clear(v, r, s)) return true;
+  }
+  undoMoves(size);
+  return false;
+}
+
+bool PushAndSwap::resolve(const int r, const int s, Nodes& U)
 {
   info("      resolve operation for", r);
   // error check
-  if (!inArray(plan.last(r), plan.last(s)->neighbor))
+  if (!inArray(config_now[r], config_now[s]->neighbor))
     halt("invalid resolve operation");
 
-  Node* ideal_loc_s = plan.last(r);
+  Node* ideal_loc_s = config_now[r];
 
   while (occupied_now[ideal_loc_s->id] != NIL) {
     const int _r = occupied_now[ideal_loc_s->id];
     if (_r == NIL) break;
     // case 1. push
-    auto p = getShortestPath(_r, ideal_loc_s, occupied_now);
+    auto p = getShortestPath(_r, ideal_loc_s);
     // required swap
     if (p.empty()) halt("never-happen situations");
+    // _r stays at its goal, resolve cannot move it
+    if (p.size() < 2) return false;
     // _r tries to move p[1]
     if (occupied_now[p[1]->id] != NIL) {
       Nodes obs = U;
-      obs.push_back(plan.last(s));
-      obs.push_back(plan.last(_r));
-      if (!pushTowardEmptyNode(p[1], plan, occupied_now, obs)) {
+      obs.push_back(config_now[s]);
+      obs.push_back(config_now[_r]);
+      if (!pushTowardEmptyNode(p[1], obs)) {
         // swap required
         info("        recursive swap is called for", r);
-        if (!swap(plan, _r, U, occupied_now)) return false;
+        if (!swap(_r, U)) return false;
       } else {
         // success
         // r moves to v
-        updatePlan(_r, p[1], plan, occupied_now);
+        updatePlan(_r, p[1]);
       }
     } else {
       // success
       // r moves to v
-      updatePlan(_r, p[1], plan, occupied_now);
+      updatePlan(_r, p[1]);
     }
   }
 
   // s moves to its goal
-  updatePlan(s, ideal_loc_s, plan, occupied_now);
-  return true;
+  if (inArray(ideal_loc_s, config_now[s]->neighbor)) {
+    updatePlan(s, ideal_loc_s);
+    return true;
+  }
+  // s was displaced by the recursive swap
+  return push(s, U) && config_now[s] == ideal_loc_s;
 }
 
-bool PushAndSwap::multiPush(Plan& plan, const int r, const int s, const Path& p,
-                            std::vector<int>& occupied_now)
+bool PushAndSwap::multiPush(const int r, const int s, const Path& p)
 {
   const int p_size = p.size();
   if (p_size == 0) halt("path is empty");
 
   // case 1
-  if (plan.last(s) != p[1]) {
+  if (config_now[s] != p[1]) {
     for (int i = 1; i < p_size; ++i) {
       // r tries to reserve v
       if (occupied_now[p[i]->id] != NIL) {
-        if (!pushTowardEmptyNode(p[i], plan, occupied_now, {plan.last(s)}))
-          return false;
+        if (!pushTowardEmptyNode(p[i], {config_now[s]})) return false;
       }
-      updatePlan(r, p[i], plan, occupied_now);
+      updatePlan(r, p[i]);
       // s moves to the last location of r;
-      updatePlan(s, p[i - 1], plan, occupied_now);
+      updatePlan(s, p[i - 1]);
     }
 
     // case 2
@@ -246,32 +235,28 @@ bool PushAndSwap::multiPush(Plan& plan, const int r, const int s, const Path& p,
       auto v = p[i];
       // s tries to reserve v
       if (occupied_now[v->id] != NIL) {
-        if (!pushTowardEmptyNode(v, plan, occupied_now, {plan.last(r)}))
-          return false;
+        if (!pushTowardEmptyNode(v, {config_now[r]})) return false;
       }
-      updatePlan(s, p[i], plan, occupied_now);
+      updatePlan(s, p[i]);
       // r moves to the last location of s;
-      updatePlan(r, p[i - 1], plan, occupied_now);
+      updatePlan(r, p[i - 1]);
     }
     // r moves to last loc of p
-    if (!pushTowardEmptyNode(p[p_size - 1], plan, occupied_now, {plan.last(r)}))
-      return false;
-    updatePlan(r, p[p_size - 1], plan, occupied_now);
+    if (!pushTowardEmptyNode(p[p_size - 1], {config_now[r]})) return false;
+    updatePlan(r, p[p_size - 1]);
   }
 
   return true;
 }
 
-void PushAndSwap::checkConsistency(Plan& plan, std::vector<int>& occupied_now)
+void PushAndSwap::checkConsistency()
 {
-  auto c = plan.last();
   for (int i = 0; i < P->getNum(); ++i) {
-    if (occupied_now[c[i]->id] != i) halt("check consistency");
+    if (occupied_now[config_now[i]->id] != i) halt("check consistency");
   }
 }
 
-bool PushAndSwap::clear(Plan& plan, Node* v, const int r, const int s,
-                        std::vector<int>& occupied_now)
+bool PushAndSwap::clear(Node* v, const int r, const int s)
 {
   info("      clear operation for", r, "at v=", v->id);
   auto getUnoccupiedNodes = [&]() {
@@ -291,16 +276,16 @@ bool PushAndSwap::clear(Plan& plan, Node* v, const int r, const int s,
     unoccupied_nodes = getUnoccupiedNodes();
     if (inArray(u, unoccupied_nodes)) continue;
     auto obs = unoccupied_nodes;
-    obs.push_back(plan.last(r));
-    obs.push_back(plan.last(s));
-    checkConsistency(plan, occupied_now);
-    if (pushTowardEmptyNode(u, plan, occupied_now, obs)) {
+    obs.push_back(config_now[r]);
+    obs.push_back(config_now[s]);
+    checkConsistency();
+    if (pushTowardEmptyNode(u, obs)) {
       if (getUnoccupiedNodes().size() >= 2) return true;
     }
   }
 
   // case 2
-  auto last_loc_s = plan.last(s);
+  auto last_loc_s = config_now[s];
   for (auto u : v->neighbor) {
     unoccupied_nodes = getUnoccupiedNodes();
     if (inArray(u, unoccupied_nodes)) continue;
@@ -311,22 +296,22 @@ bool PushAndSwap::clear(Plan& plan, Node* v, const int r, const int s,
       obs.push_back(u);
       obs.push_back(v);
       obs.push_back(w);
-      if (pushTowardEmptyNode(last_loc_s, plan, occupied_now, obs)) {
+      if (pushTowardEmptyNode(last_loc_s, obs)) {
         // move r to last_loc_s
-        updatePlan(r, last_loc_s, plan, occupied_now);
+        updatePlan(r, last_loc_s);
         // move disturbing_agent to v
-        updatePlan(disturbing_agent, v, plan, occupied_now);
+        updatePlan(disturbing_agent, v);
         // move disturbing_agent to w
-        updatePlan(disturbing_agent, w, plan, occupied_now);
+        updatePlan(disturbing_agent, w);
         // move r to v
-        updatePlan(r, v, plan, occupied_now);
+        updatePlan(r, v);
         // move s to last_loc_s
-        updatePlan(s, last_loc_s, plan, occupied_now);
+        updatePlan(s, last_loc_s);
         // move disturbing_agent to another loc
         auto obs2 = getUnoccupiedNodes();
         obs2.push_back(v);
         obs2.push_back(last_loc_s);
-        if (pushTowardEmptyNode(w, plan, occupied_now, obs2)) {
+        if (pushTowardEmptyNode(w, obs2)) {
           if (getUnoccupiedNodes().size() >= 2) return true;
           break;
         }
@@ -337,14 +322,13 @@ bool PushAndSwap::clear(Plan& plan, Node* v, const int r, const int s,
   return false;
 }
 
-void PushAndSwap::executeSwap(Plan& plan, const int r, const int s,
-                              std::vector<int>& occupied_now)
+void PushAndSwap::executeSwap(const int r, const int s)
 {
   // identify empty loc
   Node* empty1 = nullptr;
   Node* empty2 = nullptr;
-  Node* v = plan.last(r);
-  Node* last_loc_s = plan.last(s);
+  Node* v = config_now[r];
+  Node* last_loc_s = config_now[s];
   for (auto u : v->neighbor) {
     if (occupied_now[u->id] == NIL) {
       if (empty1 == nullptr) {
@@ -359,48 +343,56 @@ void PushAndSwap::executeSwap(Plan& plan, const int r, const int s,
   // error check
   if (empty2 == nullptr) halt("execute swap, failed to clear");
 
-  updatePlan(r, empty1, plan, occupied_now);
-  updatePlan(s, v, plan, occupied_now);
-  updatePlan(s, empty2, plan, occupied_now);
-  updatePlan(r, v, plan, occupied_now);
-  updatePlan(r, last_loc_s, plan, occupied_now);
-  updatePlan(s, v, plan, occupied_now);
+  updatePlan(r, empty1);
+  updatePlan(s, v);
+  updatePlan(s, empty2);
+  updatePlan(r, v);
+  updatePlan(r, last_loc_s);
+  updatePlan(s, v);
 }
 
-void PushAndSwap::updatePlan(const int id, Node* next_node, Plan& plan,
-                             std::vector<int>& occupied_now)
+void PushAndSwap::updatePlan(const int id, Node* next_node)
 {
+  Node* v_now = config_now[id];
+
   // error check
-  if (occupied_now[plan.last(id)->id] != id) halt("invalid update");
+  if (occupied_now[v_now->id] != id) halt("invalid update");
   if (occupied_now[next_node->id] != NIL) halt("vertex conflict");
 
   // update occupancy
-  occupied_now[plan.last(id)->id] = NIL;
+  occupied_now[v_now->id] = NIL;
   occupied_now[next_node->id] = id;
   // update plan
-  Config c = plan.last();
-  c[id] = next_node;
-  plan.add(c);
+  config_now[id] = next_node;
+  moves.push_back({id, v_now, next_node});
 }
 
-bool PushAndSwap::pushTowardEmptyNode(Node* v_current, Plan& plan,
-                                      std::vector<int>& occupied_now,
-                                      const Nodes& obs)
+void PushAndSwap::undoMoves(const int size)
 {
-  Node* v_empty = getNearestEmptyNode(v_current, occupied_now, obs);
+  while ((int)moves.size() > size) {
+    const Move& m = moves.back();
+    occupied_now[m.to->id] = NIL;
+    occupied_now[m.from->id] = m.id;
+    config_now[m.id] = m.from;
+    moves.pop_back();
+  }
+}
+
+bool PushAndSwap::pushTowardEmptyNode(Node* v_current, const Nodes& obs)
+{
+  Node* v_empty = getNearestEmptyNode(v_current, obs);
   if (v_empty == nullptr) return false;
   auto p = G->getPath(v_current, v_empty, obs);
   if (p.empty()) return false;
 
   for (int i = p.size() - 1; i > 0; --i) {
     if (occupied_now[p[i - 1]->id] == NIL) halt("node must be occupied");
-    updatePlan(occupied_now[p[i - 1]->id], p[i], plan, occupied_now);
+    updatePlan(occupied_now[p[i - 1]->id], p[i]);
   }
   return true;
 }
 
-Path PushAndSwap::getShortestPath(const int id, Node* s,
-                                  std::vector<int>& occupied_now)
+Path PushAndSwap::getShortestPath(const int id, Node* s)
 {
   Nodes p = {s};
   Node* g = P->getGoal(id);
@@ -422,8 +414,7 @@ Path PushAndSwap::getShortestPath(const int id, Node* s,
   return p;
 }
 
-Node* PushAndSwap::getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
-                                       const Nodes& obs)
+Node* PushAndSwap::getNearestEmptyNode(Node* v, const Nodes& obs)
 {
   const int id = occupied_now[v->id];
   Node* v_empty = nullptr;
@@ -455,12 +446,39 @@ Node* PushAndSwap::getNearestEmptyNode(Node* v, std::vector<int>& occupied_now,
   return v_empty;
 }
 
-void PushAndSwap::findNodesWithManyNeighbors()
+void PushAndSwap::initSwapVertexSearch(Node* root)
 {
-  nodes_with_many_neighbors.clear();
-  auto V = G->getV();
-  for (auto v : V)
-    if (v->getDegree() >= 3) nodes_with_many_neighbors.push_back(v);
+  // reset only visited nodes
+  for (auto i : bfs_queue) bfs_parents[i] = NIL;
+  bfs_queue.clear();
+  bfs_head = 0;
+  bfs_parents[root->id] = root->id;
+  bfs_queue.push_back(root->id);
+}
+
+Node* PushAndSwap::getNextSwapVertex()
+{
+  while (bfs_head < (int)bfs_queue.size()) {
+    Node* v = G->getNode(bfs_queue[bfs_head++]);
+    for (auto u : v->neighbor) {
+      if (bfs_parents[u->id] != NIL) continue;
+      bfs_parents[u->id] = v->id;
+      bfs_queue.push_back(u->id);
+    }
+    if (v->getDegree() >= 3) return v;
+  }
+  return nullptr;
+}
+
+Path PushAndSwap::getPathToSwapVertex(Node* v) const
+{
+  Path p = {v};
+  while (bfs_parents[v->id] != v->id) {
+    v = G->getNode(bfs_parents[v->id]);
+    p.push_back(v);
+  }
+  std::reverse(p.begin(), p.end());
+  return p;
 }
 
 /*
@@ -468,48 +486,42 @@ void PushAndSwap::findNodesWithManyNeighbors()
  *
  * c.f. MAPF-POST or MCPs
  */
-Plan PushAndSwap::compress(const Plan& plan)
+Plan PushAndSwap::compress() const
 {
-  // create table
-  std::vector<std::queue<int>> temp_orders(G->getNodesSize());
-  const int makespan = plan.getMakespan();
-  for (int t = 0; t <= makespan; ++t) {
-    for (int i = 0; i < P->getNum(); ++i) {
-      auto v = plan.get(t, i);
-      if (temp_orders[v->id].empty() || v != plan.get(t - 1, i))
-        temp_orders[v->id].push(i);
-    }
+  const int num_agents = P->getNum();
+  const int nodes_size = G->getNodesSize();
+  Config config = P->getConfigStart();
+
+  // create table, agents entering each node in order, stored contiguously
+  std::vector<int> heads(nodes_size + 1, 0);
+  for (auto v : config) ++heads[v->id + 1];
+  for (auto& m : moves) ++heads[m.to->id + 1];
+  for (int i = 0; i < nodes_size; ++i) heads[i + 1] += heads[i];
+  std::vector<int> temp_orders(heads[nodes_size]);
+  {
+    std::vector<int> tails(heads.begin(), heads.end() - 1);
+    for (int i = 0; i < num_agents; ++i) temp_orders[tails[config[i]->id]++] = i;
+    for (auto& m : moves) temp_orders[tails[m.to->id]++] = m.id;
   }
-  Plan new_plan;
-  new_plan.add(plan.get(0));
-  std::vector<int> internal_clocks(P->getNum(), 0);
-
-  while (!sameConfig(new_plan.last(), P->getConfigGoal())) {
-    Config config;
-    for (int i = 0; i < P->getNum(); ++i) {
-      int t = internal_clocks[i];
-      // already reach its goal
-      if (t == makespan) {
-        config.push_back(new_plan.last(i));
-        continue;
-      }
-      Node* v_current = plan.get(t, i);
-      // update internal clocks
-      while (t < makespan && v_current == plan.get(t + 1, i)) ++t;
-      internal_clocks[i] = t;
-      // already reach its goal
-      if (t == makespan) {
-        config.push_back(new_plan.last(i));
-        continue;
-      }
 
-      Node* v_next = plan.get(t + 1, i);
-      if (temp_orders[v_next->id].front() == i) {  // move to v_next
-        config.push_back(v_next);
-        temp_orders[v_current->id].pop();
+  // locations visited by each agent
+  std::vector<Nodes> next_locs(num_agents);
+  for (auto& m : moves) next_locs[m.id].push_back(m.to);
+  std::vector<int> internal_clocks(num_agents, 0);
+
+  Plan new_plan;
+  new_plan.add(config);
+  while (!sameConfig(config, P->getConfigGoal())) {
+    for (int i = 0; i < num_agents; ++i) {
+      // no more moves
+      const int t = internal_clocks[i];
+      if (t == (int)next_locs[i].size()) continue;
+
+      Node* v_next = next_locs[i][t];
+      if (temp_orders[heads[v_next->id]] == i) {  // move to v_next
+        ++heads[config[i]->id];
+        config[i] = v_next;
         internal_clocks[i] = t + 1;  // update internal clocks
-      } else {                       // stay
-        config.push_back(new_plan.last(i));
       }
     }
     new_plan.add(config);
@@ -517,6 +529,18 @@ Plan PushAndSwap::compress(const Plan& plan)
   return new_plan;
 }
 
+Plan PushAndSwap::getPlan() const
+{
+  Plan plan;
+  Config config = P->getConfigStart();
+  plan.add(config);
+  for (auto& m : moves) {
+    config[m.id] = m.to;
+    plan.add(config);
+  }
+  return plan;
+}
+
 void PushAndSwap::setParams(int argc, char* argv[])
 {
   struct option longopts[] = {
@@ -0,0 +1,103 @@
+#include "../include/reservation_table.hpp"
+
+#include <algorithm>
+
+static bool isIgnored(const int i, const std::vector<int>& ignored)
+{
+  return !ignored.empty() &&
+         std::binary_search(ignored.begin(), ignored.end(), i);
+}
+
+ReservationTable::ReservationTable(const Plan& plan,
+                                   const std::vector<int>& agents)
+{
+  if (plan.empty()) return;
+  for (auto i : agents) add(i, plan.getPath(i));
+}
+
+void ReservationTable::add(const int i, const Path& path)
+{
+  if (path.empty()) return;
+  const int cost = getPathCost(path);
+  if ((int)body.size() < cost) body.resize(cost);
+  for (int t = 0; t < cost; ++t) body[t][path[t]->id] = i;
+  goals[path[cost]->id] = std::make_tuple(i, cost);
+}
+
+void ReservationTable::remove(const int i, const Path& path)
+{
+  if (path.empty()) return;
+  const int cost = getPathCost(path);
+  for (int t = 0; t < cost && t < (int)body.size(); ++t) {
+    auto itr = body[t].find(path[t]->id);
+    if (itr != body[t].end() && itr->second == i) body[t].erase(itr);
+  }
+  auto itr = goals.find(path[cost]->id);
+  if (itr != goals.end() && std::get<0>(itr->second) == i) goals.erase(itr);
+  // cutoff unused timesteps
+  while (!body.empty() && (body.end() - 1)->empty()) body.pop_back();
+}
+
+void ReservationTable::clear()
+{
+  body.clear();
+  goals.clear();
+}
+
+bool ReservationTable::empty() const { return body.empty() && goals.empty(); }
+
+int ReservationTable::get(const int t, Node* const v,
+                          const std::vector<int>& ignored) const
+{
+  if (t < 0) return NIL;
+  // moving agents
+  if (t < (int)body.size()) {
+    auto itr = body[t].find(v->id);
+    if (itr != body[t].end()) {
+      return isIgnored(itr->second, ignored) ? NIL : itr->second;
+    }
+  }
+  // agents at goals
+  auto itr = goals.find(v->id);
+  if (itr != goals.end() && std::get<1>(itr->second) <= t) {
+    const int i = std::get<0>(itr->second);
+    return isIgnored(i, ignored) ? NIL : i;
+  }
+  return NIL;
+}
+
+bool ReservationTable::isConflicted(Node* const u, Node* const v, const int t,
+                                    const std::vector<int>& ignored) const
+{
+  // vertex conflict
+  if (get(t, v, ignored) != NIL) return true;
+  // swap conflict
+  const int j = get(t - 1, v, ignored);
+  if (j != NIL && u != v && get(t, u, ignored) == j) return true;
+  return false;
+}
+
+bool ReservationTable::isConflicted(const Path& path,
+                                    const std::vector<int>& ignored) const
+{
+  if (path.empty()) return false;
+  const int cost = getPathCost(path);
+  if (get(0, path[0], ignored) != NIL) return true;
+  for (int t = 1; t <= cost; ++t) {
+    if (isConflicted(path[t - 1], path[t], t, ignored)) return true;
+  }
+  // someone uses the goal after arrival
+  return getLastReservedTime(path[cost], ignored) > cost;
+}
+
+int ReservationTable::getLastReservedTime(Node* const v,
+                                          const std::vector<int>& ignored) const
+{
+  for (int t = body.size() - 1; t >= 0; --t) {
+    auto itr = body[t].find(v->id);
+    if (itr != body[t].end() && !isIgnored(itr->second, ignored)) return t;
+  }
+  return NIL;
+}
+
+int ReservationTable::getMakespan() const { return body.size() - 1; }
@@ -0,0 +1,280 @@
+#include "../include/result.hpp"
+
+#include <sstream>
+
+static const char RESULT_MAGIC[] = "MAPF";
+static const int RESULT_VERSION = 1;
+static const int RESULT_FLAG_DEFLATE = 1;
+
+static bool endsWith(const std::string& s, const std::string& suffix)
+{
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// -------------------------------
+// writer
+// -------------------------------
+ResultWriter::ResultWriter(const std::string& _file_name,
+                           const bool _compressed)
+    : file_name(_file_name), compressed(false), config_started(false)
+{
+  file.open(file_name, std::ios::out | std::ios::binary);
+  if (!file) halt("cannot open " + file_name);
+
+#ifdef MAPF_USE_ZLIB
+  if (_compressed) {
+    zs.zalloc = Z_NULL;
+    zs.zfree = Z_NULL;
+    zs.opaque = Z_NULL;
+    if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK) {
+      halt("failed to initialize compression");
+    }
+    compressed = true;
+  }
+#endif
+
+  // header is never compressed
+  file.write(RESULT_MAGIC, 4);
+  file.put((char)RESULT_VERSION);
+  file.put((char)(compressed ? RESULT_FLAG_DEFLATE : 0));
+  buf.reserve(BUFFER_SIZE);
+}
+
+ResultWriter::~ResultWriter()
+{
+  if (file.is_open()) {
+    try {
+      close();
+    } catch (const MAPFError&) {
+    }
+  }
+#ifdef MAPF_USE_ZLIB
+  if (compressed) deflateEnd(&zs);
+#endif
+}
+
+void ResultWriter::putVarint(uint64_t x)
+{
+  while (x >= 0x80) {
+    buf.push_back((char)((x & 0x7f) | 0x80));
+    x >>= 7;
+  }
+  buf.push_back((char)x);
+}
+
+void ResultWriter::putSignedVarint(int64_t x)
+{
+  // zigzag, small absolute values -> small numbers
+  putVarint(((uint64_t)x << 1) ^ (uint64_t)(x >> 63));
+}
+
+void ResultWriter::writeStartsGoals(const int width, const Config& starts,
+                                    const Config& goals)
+{
+  if (config_started) halt("starts and goals are already written");
+  putVarint(width);
+  putVarint(starts.size());
+  last_ids.clear();
+  for (auto v : starts) {
+    putVarint(v->id);
+    last_ids.push_back(v->id);
+  }
+  for (auto v : goals) putVarint(v->id);
+  config_started = true;
+}
+
+void ResultWriter::addConfig(const Config& config)
+{
+  if (!config_started) halt("starts and goals are not written");
+  const int num_agents = last_ids.size();
+  if ((int)config.size() != num_agents) halt("invalid configuration");
+
+  // moved agents only
+  int moved = 0;
+  for (int i = 0; i < num_agents; ++i) moved += (config[i]->id != last_ids[i]);
+  putVarint(moved + 1);
+  for (int i = 0, prev = 0; i < num_agents; ++i) {
+    if (config[i]->id == last_ids[i]) continue;
+    putVarint(i - prev);
+    putSignedVarint((int64_t)config[i]->id - last_ids[i]);
+    last_ids[i] = config[i]->id;
+    prev = i;
+  }
+  if ((int)buf.size() >= BUFFER_SIZE) flush();
+}
+
+void ResultWriter::close(const std::string& info)
+{
+  if (!file.is_open()) return;
+  if (!config_started) writeStartsGoals(0, {}, {});
+  putVarint(0);  // end of timesteps
+  putVarint(info.size());
+  buf += info;
+  flush(true);
+  file.close();
+}
+
+void ResultWriter::flush(const bool finish)
+{
+  if (!compressed) {
+    file.write(buf.data(), buf.size());
+  }
+#ifdef MAPF_USE_ZLIB
+  else {
+    char out[BUFFER_SIZE];
+    zs.next_in = reinterpret_cast<Bytef*>(buf.data());
+    zs.avail_in = buf.size();
+    do {
+      zs.next_out = reinterpret_cast<Bytef*>(out);
+      zs.avail_out = BUFFER_SIZE;
+      if (deflate(&zs, finish ? Z_FINISH : Z_NO_FLUSH) == Z_STREAM_ERROR) {
+        halt("failed to compress");
+      }
+      file.write(out, BUFFER_SIZE - zs.avail_out);
+    } while (zs.avail_out == 0);
+  }
+#endif
+  buf.clear();
+  if (!file) halt("failed to write " + file_name);
+}
+
+bool ResultWriter::isBinaryFile(const std::string& file_name)
+{
+  return endsWith(file_name, ".bin") || isCompressedFile(file_name);
+}
+
+bool ResultWriter::isCompressedFile(const std::string& file_name)
+{
+  return endsWith(file_name, ".binz");
+}
+
+void ResultWriter::halt(const std::string& msg) const
+{
+  throw MAPFError("error@ResultWriter: " + msg);
+}
+
+// -------------------------------
+// reader
+// -------------------------------
+ResultReader::ResultReader(const std::string& file_name) : pos(0), width(0)
+{
+  std::ifstream file(file_name, std::ios::in | std::ios::binary);
+  if (!file) halt("file " + file_name + " is not found.");
+  std::stringstream ss;
+  ss << file.rdbuf();
+  const std::string data = ss.str();
+
+  // header
+  if (data.size() < 6 || data.compare(0, 4, RESULT_MAGIC) != 0) {
+    halt(file_name + " is not a binary result");
+  }
+  if ((int)data[4] != RESULT_VERSION) halt("unknown version");
+  const bool compressed = data[5] & RESULT_FLAG_DEFLATE;
+
+  // body
+  if (!compressed) {
+    body = data.substr(6);
+  } else {
+#ifdef MAPF_USE_ZLIB
+    z_stream zs;
+    zs.zalloc = Z_NULL;
+    zs.zfree = Z_NULL;
+    zs.opaque = Z_NULL;
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + 6));
+    zs.avail_in = data.size() - 6;
+    if (inflateInit(&zs) != Z_OK) halt("failed to initialize decompression");
+    char out[1 << 16];
+    int ret = Z_OK;
+    while (ret != Z_STREAM_END) {
+      zs.next_out = reinterpret_cast<Bytef*>(out);
+      zs.avail_out = sizeof(out);
+      ret = inflate(&zs, Z_NO_FLUSH);
+      if (ret != Z_OK && ret != Z_STREAM_END) {
+        inflateEnd(&zs);
+        halt("broken compressed result");
+      }
+      body.append(out, sizeof(out) - zs.avail_out);
+    }
+    inflateEnd(&zs);
+#else
+    halt("compressed results require zlib");
+#endif
+  }
+
+  // starts and goals
+  width = getVarint();
+  const int num_agents = getVarint();
+  for (int i = 0; i < num_agents; ++i) starts.push_back(getVarint());
+  for (int i = 0; i < num_agents; ++i) goals.push_back(getVarint());
+
+  // configurations
+  std::vector<int> config = starts;
+  while (true) {
+    const int moved = (int)getVarint() - 1;
+    if (moved < 0) break;
+    for (int j = 0, i = 0; j < moved; ++j) {
+      i += getVarint();
+      if (i >= num_agents) halt("invalid agent");
+      config[i] += getSignedVarint();
+    }
+    configs.push_back(config);
+  }
+
+  // other lines
+  const size_t info_size = getVarint();
+  if (pos + info_size > body.size()) halt("truncated result");
+  info = body.substr(pos, info_size);
+  pos += info_size;
+}
+
+uint64_t ResultReader::getVarint()
+{
+  uint64_t x = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (pos >= body.size()) halt("truncated result");
+    const uint8_t b = body[pos++];
+    x |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) return x;
+  }
+  halt("invalid varint");
+  return x;
+}
+
+int64_t ResultReader::getSignedVarint()
+{
+  const uint64_t x = getVarint();
+  return (int64_t)(x >> 1) ^ -(int64_t)(x & 1);
+}
+
+void ResultReader::writeText(std::ostream& log) const
+{
+  auto writeLoc = [&](const int id) {
+    log << "(" << id % width << "," << id / width << "),";
+  };
+  log << info;
+  log << "starts=";
+  for (auto id : starts) writeLoc(id);
+  log << "\ngoals=";
+  for (auto id : goals) writeLoc(id);
+  log << "\n";
+  log << "solution=\n";
+  const int configs_size = configs.size();
+  for (int t = 0; t < configs_size; ++t) {
+    log << t << ":";
+    for (auto id : configs[t]) writeLoc(id);
+    log << "\n";
+  }
+}
+
+void ResultReader::writeText(const std::string& file_name) const
+{
+  std::ofstream log(file_name, std::ios::out);
+  if (!log) halt("cannot open " + file_name);
+  writeText(log);
+}
+
+void ResultReader::halt(const std::string& msg) const
+{
+  throw MAPFError("error@ResultReader: " + msg);
+}
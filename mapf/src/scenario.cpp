@@ -0,0 +1,93 @@
+#include "../include/scenario.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "../include/mapped_file.hpp"
+
+static bool isBlank(const char c) { return c == ' ' || c == '\t'; }
+
+Scenario::Scenario(const std::string& _file_name)
+    : file_name(_file_name), map_file(""), width(0), height(0)
+{
+  MappedFile file(file_name);
+  if (!file.isOpen()) halt("file " + file_name + " is not found.");
+
+  const char* const end = file.data() + file.size();
+  int line_num = 0;
+  for (const char *l = file.data(), *e = l; l < end; l = e + 1) {
+    e = static_cast<const char*>(std::memchr(l, '\n', end - l));
+    if (e == nullptr) e = end;
+    ++line_num;
+    const char* line_end = e;
+    // for CRLF coding
+    if (line_end > l && *(line_end - 1) == 0x0d) --line_end;
+
+    // split into columns
+    std::vector<std::pair<const char*, const char*>> cols;
+    for (const char* p = l; p < line_end;) {
+      while (p < line_end && isBlank(*p)) ++p;
+      if (p == line_end) break;
+      const char* q = p;
+      while (q < line_end && !isBlank(*q)) ++q;
+      cols.emplace_back(p, q);
+      p = q;
+    }
+    if (cols.empty()) continue;
+    if (line_num == 1 && std::string(cols[0].first, cols[0].second) ==
+                             "version") {
+      continue;
+    }
+
+    auto invalid = [&]() {
+      halt("invalid line " + std::to_string(line_num) + " of " + file_name);
+    };
+    if (cols.size() != 9) invalid();
+
+    // map, directories are dropped
+    std::string map(cols[1].first, cols[1].second);
+    const auto pos = map.find_last_of('/');
+    if (pos != std::string::npos) map = map.substr(pos + 1);
+    int w, h;
+    if (!parseUInt(cols[2].first, cols[2].second, w) ||
+        !parseUInt(cols[3].first, cols[3].second, h)) {
+      invalid();
+    }
+    if (entries.empty()) {
+      map_file = map;
+      width = w;
+      height = h;
+    } else if (map != map_file || w != width || h != height) {
+      halt("multiple maps in " + file_name);
+    }
+
+    Entry entry;
+    if (!parseUInt(cols[0].first, cols[0].second, entry.bucket) ||
+        !parseUInt(cols[4].first, cols[4].second, entry.x_s) ||
+        !parseUInt(cols[5].first, cols[5].second, entry.y_s) ||
+        !parseUInt(cols[6].first, cols[6].second, entry.x_g) ||
+        !parseUInt(cols[7].first, cols[7].second, entry.y_g)) {
+      invalid();
+    }
+    const std::string length(cols[8].first, cols[8].second);
+    char* length_end;
+    entry.optimal_length = std::strtod(length.c_str(), &length_end);
+    if (*length_end != '\0') invalid();
+    entries.push_back(entry);
+  }
+
+  if (entries.empty()) halt("no agents in " + file_name);
+}
+
+bool Scenario::isScenFile(const std::string& file_name)
+{
+  const std::string suffix = ".scen";
+  return file_name.size() >= suffix.size() &&
+         file_name.compare(file_name.size() - suffix.size(), suffix.size(),
+                           suffix) == 0;
+}
+
+void Scenario::halt(const std::string& msg) const
+{
+  throw MAPFError("error@Scenario: " + msg);
+}
@@ -0,0 +1,65 @@
+#include "../include/solution_stream.hpp"
+
+SolutionStream::SolutionStream(const std::string& _file_name,
+                               const std::string& header)
+    : file_name(_file_name), closed(false)
+{
+  file.open(file_name, std::ios::out);
+  if (!file) throw MAPFError("error@SolutionStream: cannot open " + file_name);
+  file << header;
+  file.flush();
+  worker = std::thread(&SolutionStream::work, this);
+}
+
+SolutionStream::~SolutionStream() { close(); }
+
+void SolutionStream::push(Record&& record)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    queue.push_back(std::move(record));
+  }
+  cv.notify_one();
+}
+
+void SolutionStream::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (closed) return;
+    closed = true;
+  }
+  cv.notify_one();
+  worker.join();
+  file << "end\n";
+  file.close();
+}
+
+void SolutionStream::work()
+{
+  std::deque<Record> records;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [&] { return closed || !queue.empty(); });
+      if (queue.empty()) return;  // closed
+      std::swap(records, queue);
+    }
+    // readers see records as soon as they are written
+    for (auto& record : records) write(record);
+    file.flush();
+    records.clear();
+  }
+}
+
+void SolutionStream::write(const Record& record)
+{
+  file << "iter=" << record.iteration << ",comp_time=" << record.comp_time
+       << ",soc=" << record.soc << ",makespan=" << record.makespan
+       << ",agents=" << record.paths.size() << "\n";
+  for (auto& [id, path] : record.paths) {
+    file << id << ":";
+    for (auto v : path) file << "(" << v->pos.x << "," << v->pos.y << "),";
+    file << "\n";
+  }
+}
@@ -2,17 +2,21 @@
 
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "../include/lib_cbs.hpp"
+#include "../include/result.hpp"
 
 MinimumSolver::MinimumSolver(Problem* _P)
   : solver_name(""),
     P(_P),
     G(_P->getG()),
-    MT(_P->getMT()),
+    rng(std::make_shared<std::mt19937>((*_P->getMT())())),
+    MT(rng.get()),
     max_timestep(P->getMaxTimestep()),
     max_comp_time(P->getMaxCompTime()),
     solved(false),
+    token(_P->getCancelToken()),
     comp_time(0)
 {
 }
@@ -27,6 +31,8 @@ void MinimumSolver::solve()
 void MinimumSolver::start()
 {
   t_start = Time::now();
+  token = std::make_shared<CancelToken>(
+      P->getCancelToken(), t_start + std::chrono::milliseconds(max_comp_time));
 }
 
 void MinimumSolver::end()
@@ -45,16 +51,14 @@ Solver::Solver(Problem* _P)
     verbose(false),
     LB_soc(0),
     LB_makespan(0),
-    distance_table(P->getNum(),
-                   std::vector<int>(G->getNodesSize(), max_timestep)),
-    distance_table_p(nullptr)
+    distance_table_p(nullptr),
+    distance_cache_p(nullptr),
+    mdd_table_p(nullptr),
+    result_writer(nullptr)
 {
 }
 
-Solver::~Solver()
-{
-  if (P->isInitializedInstance()) LibCBS::MDD::PURE_MDD_TABLE.clear();
-}
+Solver::~Solver() {}
 
 // -------------------------------
 // main
@@ -76,13 +80,13 @@ void Solver::exec()
 // -------------------------------
 int Solver::getRemainedTime() const
 {
+  // deadlines of the parents are also respected
+  const int t = token->getRemainedTime();
+  if (t >= 0) return t;
   return std::max(0, max_comp_time - getSolverElapsedTime());
 }
 
-bool Solver::overCompTime() const
-{
-  return getSolverElapsedTime() >= max_comp_time;
-}
+bool Solver::overCompTime() const { return token->isExpired(); }
 
 // -------------------------------
 // utilities for problem instance
@@ -155,9 +159,7 @@ void Solver::info() const
 
 void Solver::halt(const std::string& msg) const
 {
-  std::cout << "error@" << solver_name << ": " << msg << std::endl;
-  this->~Solver();
-  std::exit(1);
+  throw MAPFError("error@" + solver_name + ": " + msg);
 }
 
 void Solver::warn(const std::string& msg) const
@@ -170,14 +172,35 @@ void Solver::warn(const std::string& msg) const
 // -------------------------------
 void Solver::makeLog(const std::string& logfile)
 {
+  // binary, the other lines are stored after the solution
+  if (ResultWriter::isBinaryFile(logfile)) {
+    ResultWriter writer(logfile, ResultWriter::isCompressedFile(logfile));
+    std::ostringstream log;
+    result_writer = &writer;
+    try {
+      writeLog(log);
+    } catch (...) {
+      result_writer = nullptr;
+      throw;
+    }
+    result_writer = nullptr;
+    writer.close(log.str());
+    return;
+  }
+
   std::ofstream log;
   log.open(logfile, std::ios::out);
+  writeLog(log);
+  log.close();
+}
+
+void Solver::writeLog(std::ostream& log)
+{
   makeLogBasicInfo(log);
   makeLogSolution(log);
-  log.close();
 }
 
-void Solver::makeLogBasicInfo(std::ofstream& log)
+void Solver::makeLogBasicInfo(std::ostream& log)
 {
   Grid* grid = reinterpret_cast<Grid*>(P->getG());
   log << "instance=" << P->getInstanceFileName() << "\n";
@@ -192,8 +215,18 @@ void Solver::makeLogBasicInfo(std::ofstream& log)
   log << "comp_time=" << getCompTime() << "\n";
 }
 
-void Solver::makeLogSolution(std::ofstream& log)
+void Solver::makeLogSolution(std::ostream& log)
 {
+  if (result_writer != nullptr) {
+    Grid* grid = reinterpret_cast<Grid*>(P->getG());
+    result_writer->writeStartsGoals(grid->getWidth(), P->getConfigStart(),
+                                    P->getConfigGoal());
+    for (int t = 0; t <= solution.getMakespan(); ++t) {
+      result_writer->addConfig(solution.get(t));
+    }
+    return;
+  }
+
   log << "starts=";
   for (int i = 0; i < P->getNum(); ++i) {
     Node* v = P->getStart(i);
@@ -219,6 +252,8 @@ void Solver::makeLogSolution(std::ofstream& log)
 // -------------------------------
 // utilities for solver options
 // -------------------------------
+std::mutex Solver::option_mtx;
+
 void Solver::setSolverOption(std::shared_ptr<Solver> solver,
                              const std::vector<std::string>& option)
 {
@@ -229,6 +264,7 @@ void Solver::setSolverOption(std::shared_ptr<Solver> solver,
     char* tmp = const_cast<char*>(option[i - 1].c_str());
     argv[i] = tmp;
   }
+  std::lock_guard<std::mutex> lock(option_mtx);
   solver->setParams(argc, argv);
 }
 
@@ -259,6 +295,9 @@ void Solver::printHelpWithoutOption(const std::string& solver_name)
 int Solver::pathDist(const int i, Node* const s) const
 {
   if (distance_table_p != nullptr) {
+    if (!distance_table_ids.empty()) {
+      return distance_table_p->operator[](distance_table_ids[i])[s->id];
+    }
     return distance_table_p->operator[](i)[s->id];
   }
   return distance_table[i][s->id];
@@ -266,28 +305,53 @@ int Solver::pathDist(const int i, Node* const s) const
 
 int Solver::pathDist(const int i) const { return pathDist(i, P->getStart(i)); }
 
+void Solver::setDistanceTable(DistanceTable* p, const std::vector<int>& ids)
+{
+  distance_table_p = p;
+  distance_table_ids = ids;
+}
+
 void Solver::createDistanceTable()
 {
+  // allocated only when used, nested solvers usually refer to others
+  distance_table.resize(P->getNum());
   for (int i = 0; i < P->getNum(); ++i) {
-    // breadth first search
-    std::queue<Node*> OPEN;
-    Node* n = P->getGoal(i);
-    OPEN.push(n);
-    distance_table[i][n->id] = 0;
-    while (!OPEN.empty()) {
-      n = OPEN.front();
-      OPEN.pop();
-      const int d_n = distance_table[i][n->id];
-      for (auto m : n->neighbor) {
-        const int d_m = distance_table[i][m->id];
-        if (d_n + 1 >= d_m) continue;
-        distance_table[i][m->id] = d_n + 1;
-        OPEN.push(m);
+    if (distance_cache_p != nullptr) {
+      auto itr = distance_cache_p->find(P->getGoal(i)->id);
+      if (itr != distance_cache_p->end()) {
+        distance_table[i] = itr->second;
+        continue;
       }
     }
+    distance_table[i] = createDistanceRow(P->getGoal(i));
+    if (distance_cache_p != nullptr) {
+      (*distance_cache_p)[P->getGoal(i)->id] = distance_table[i];
+    }
   }
 }
 
+std::vector<int> Solver::createDistanceRow(Node* const g) const
+{
+  std::vector<int> dist(G->getNodesSize(), max_timestep);
+  // breadth first search
+  std::queue<Node*> OPEN;
+  Node* n = g;
+  OPEN.push(n);
+  dist[n->id] = 0;
+  while (!OPEN.empty()) {
+    n = OPEN.front();
+    OPEN.pop();
+    const int d_n = dist[n->id];
+    for (auto m : n->neighbor) {
+      const int d_m = dist[m->id];
+      if (d_n + 1 >= d_m) continue;
+      dist[m->id] = d_n + 1;
+      OPEN.push(m);
+    }
+  }
+  return dist;
+}
+
 // -------------------------------
 // utilities for getting path
 // -------------------------------
@@ -304,13 +368,14 @@ std::string Solver::AstarNode::getName(Node* _v, int _g)
 Path Solver::getPathBySpaceTimeAstar
 (Node* const s,
  Node* const g,
- AstarHeuristics& fValue,
- CompareAstarNode& compare,
- CheckAstarFin& checkAstarFin,
- CheckInvalidAstarNode& checkInvalidAstarNode,
- const int time_limit)
+ const AstarHeuristics& fValue,
+ const CompareAstarNode& compare,
+ const CheckAstarFin& checkAstarFin,
+ const CheckInvalidAstarNode& checkInvalidAstarNode,
+ const int time_limit,
+ const CancelToken* const token)
 {
-  auto t_start = Time::now();
+  CancelPoller poller(token, time_limit);
 
   AstarNodes GC;  // garbage collection
   auto createNewNode = [&GC](Node* v, int g, int f, AstarNode* p) {
@@ -331,8 +396,8 @@ Path Solver::getPathBySpaceTimeAstar
   // main loop
   bool invalid = true;
   while (!OPEN.empty()) {
-    // check time limit
-    if (time_limit > 0 && getElapsedTime(t_start) > time_limit) break;
+    // check time limit and cancellation
+    if (poller.stop()) break;
 
     // minimum node
     n = OPEN.top();
@@ -379,7 +444,7 @@ Path Solver::getPathBySpaceTimeAstar
 }
 
 
-Solver::CompareAstarNode Solver::compareAstarNodeBasic =
+const Solver::CompareAstarNode Solver::compareAstarNodeBasic =
   [](AstarNode* a, AstarNode* b) {
     if (a->f != b->f) return a->f > b->f;
     if (a->g != b->g) return a->g < b->g;
@@ -392,7 +457,7 @@ Path Solver::getPrioritizedPath
  const int time_limit,
  const int upper_bound,
  const std::vector<std::tuple<Node*, int>>& constraints,
- CompareAstarNode& compare,
+ const CompareAstarNode& compare,
  const bool manage_path_table)
 {
   Node* const s = P->getStart(id);
@@ -464,7 +529,8 @@ Path Solver::getPrioritizedPath
   };
 
   auto p = getPathBySpaceTimeAstar(s, g, fValue, compare, checkAstarFin,
-                                   checkInvalidAstarNode, time_limit);
+                                   checkInvalidAstarNode, time_limit,
+                                   token.get());
 
   // clear used path table
   if (manage_path_table) clearPathTable(paths);
@@ -12,64 +12,119 @@ WHCA::WHCA(Problem* _P) : Solver(_P), table_goals(G->getNodesSize(), false)
 void WHCA::run()
 {
   // initialize
-  Paths paths(P->getNum());
-  for (int i = 0; i < P->getNum(); ++i) {
-    paths.insert(i, {P->getStart(i)});
-    table_goals[P->getGoal(i)->id] = true;
-  }
+  const int num_agents = P->getNum();
+  for (int i = 0; i < num_agents; ++i) table_goals[P->getGoal(i)->id] = true;
+  Config config = P->getConfigStart();
+  solution.add(config);
+  partial_paths = Paths(num_agents);
+  arrivals.assign(num_agents, 0);
+  planned_nums.assign(num_agents, 0);
+  // partial paths are at most window + 1
+  PATH_TABLE.assign(window + 1, std::vector<int>(G->getNodesSize(), NIL));
 
   // initial prioritization, far agent is prioritized
-  std::vector<int> ids(P->getNum());
+  std::vector<int> ids(num_agents);
   std::iota(ids.begin(), ids.end(), 0);
 
   // start planning
-  int iteration = 0;
   while (true) {
     info(" ", "elapsed:", getSolverElapsedTime(),
-         ", timestep:", iteration * window);
-    ++iteration;
+         ", timestep:", solution.getMakespan());
 
     if (!disable_dist_init) {
       std::sort(ids.begin(), ids.end(),
                 [&](int a, int b)
-                { return pathDist(a, paths.last(a)) > pathDist(b, paths.last(b)); });
+                { return pathDist(a, config[a]) > pathDist(b, config[b]); });
     }
 
-    bool check_goal_cond = true;
-    Paths partial_paths(P->getNum());
-    bool invalid = false;
-    for (int j = 0; j < P->getNum(); ++j) {
-      int i = ids[j];
-      Node* s = *(paths.get(i).end() - 1);
-      Node* g = P->getGoal(i);
-      Path path = getPrioritizedPartialPath(i, s, g, partial_paths);
-      if (path.empty()) {  // failed
-        invalid = true;
-        info("  ", "failed to find a path");
-        break;
-      }
-      partial_paths.insert(i, path);
-      check_goal_cond &= (*(path.end() - 1) == g);
+    // replan all agents when reused paths do not work
+    if (!(reuse && planWindow(ids, config, true)) &&
+        !planWindow(ids, config, false)) {
+      info("  ", "failed to find a path");
+      break;
     }
-    if (invalid) break;
-    paths += partial_paths;
 
-    // clear cache
-    clearPathTable(partial_paths);
+    // update plan
+    const int makespan = partial_paths.getMakespan();
+    for (int t = 1; t <= makespan; ++t) {
+      for (int i = 0; i < num_agents; ++i) config[i] = partial_paths.get(i, t);
+      solution.add(config);
+    }
 
     // check goal condition
-    if (check_goal_cond) {
+    if (sameConfig(config, P->getConfigGoal())) {
       solved = true;
       break;
     }
 
     // check limitation
-    if (overCompTime() || paths.getMakespan() > max_timestep) {
+    if (overCompTime() || solution.getMakespan() > max_timestep) {
       break;
     }
   }
+}
 
-  solution = pathsToPlan(paths);
+bool WHCA::planWindow(const std::vector<int>& ids, const Config& config,
+                      const bool reuse_paths)
+{
+  const int num_agents = P->getNum();
+
+  // remove reservations of the previous window
+  Paths next_paths(num_agents);
+  std::vector<bool> kept(num_agents, false);
+  for (int i = 0; i < num_agents; ++i) {
+    if (partial_paths.empty(i)) continue;
+    Node* g = P->getGoal(i);
+    if (reuse_paths && partial_paths.last(i) == g) {
+      // keep staying at the goal, only moves before the arrival are removed
+      for (int t = 0; t < arrivals[i]; ++t) {
+        auto v_id = partial_paths.get(i, t)->id;
+        if (PATH_TABLE[t][v_id] == i) PATH_TABLE[t][v_id] = NIL;
+        PATH_TABLE[t][g->id] = i;
+      }
+      arrivals[i] = 0;
+      next_paths.insert(i, {g});
+      kept[i] = true;
+    } else {
+      clearPath(i);
+    }
+  }
+  partial_paths = next_paths;
+
+  // plan the others
+  for (auto i : ids) {
+    if (kept[i]) continue;
+    Node* s = config[i];
+    Node* g = P->getGoal(i);
+    Path path = getPrioritizedPartialPath(i, s, g, partial_paths);
+    ++planned_nums[i];
+    if (path.empty()) return false;
+    partial_paths.insert(i, path);
+    arrivals[i] = path.size() - 1;
+
+    // a kept path in front of a stuck agent is no longer valid
+    if (reuse_paths && path.back() != g &&
+        pathDist(i, path.back()) >= pathDist(i, s)) {
+      for (auto u : s->neighbor) {
+        const int j = PATH_TABLE[0][u->id];
+        if (j != NIL && kept[j] && pathDist(i, u) < pathDist(i, s)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void WHCA::clearPath(const int id)
+{
+  const int makespan = partial_paths.getMakespan();
+  const int table_makespan = PATH_TABLE.size() - 1;
+  // including the padding of the path
+  for (int t = 0; t <= table_makespan; ++t) {
+    auto v_id = partial_paths.get(id, std::min(t, makespan))->id;
+    if (PATH_TABLE[t][v_id] == id) PATH_TABLE[t][v_id] = NIL;
+  }
 }
 
 Path WHCA::getPrioritizedPartialPath(int id, Node* s, Node* g,
@@ -77,16 +132,11 @@ Path WHCA::getPrioritizedPartialPath(int id, Node* s, Node* g,
 {
   const int makespan = paths.getMakespan();
 
-  // pre processing
+  // pre processing, the last use of the goal by others
   int max_constraint_time = 0;
-  for (int i = 0; i < P->getNum(); ++i) {
-    Path p = paths.get(i);
-    if (p.empty() || i == id) continue;
-    for (int t = 0; t <= makespan; ++t) {
-      if (paths.get(i, t) == g) {
-        max_constraint_time = std::max(t, max_constraint_time);
-      }
-    }
+  for (int t = 0; t <= makespan; ++t) {
+    const int i = PATH_TABLE[t][g->id];
+    if (i != Solver::NIL && i != id) max_constraint_time = t;
   }
 
   // in this case, the greedy f-value fails a lot, different from HCA*
@@ -111,24 +161,22 @@ Path WHCA::getPrioritizedPartialPath(int id, Node* s, Node* g,
   // fast collision checking
   CheckInvalidAstarNode checkInvalidAstarNode = [&](AstarNode* m) {
     if (m->g > window) return true;
-    // last node
-    if (makespan > 0) {
-      if (m->g > makespan) {
-        if (PATH_TABLE[makespan][m->v->id] != Solver::NIL) return true;
-      } else {
-        // vertex conflict
-        if (PATH_TABLE[m->g][m->v->id] != Solver::NIL) return true;
-        // swap conflict
-        if (PATH_TABLE[m->g][m->p->v->id] != Solver::NIL &&
-            PATH_TABLE[m->g - 1][m->v->id] == PATH_TABLE[m->g][m->p->v->id])
-          return true;
-      }
+    // last node, kept paths are registered even when makespan is zero
+    if (m->g > makespan) {
+      if (PATH_TABLE[makespan][m->v->id] != Solver::NIL) return true;
+    } else {
+      // vertex conflict
+      if (PATH_TABLE[m->g][m->v->id] != Solver::NIL) return true;
+      // swap conflict
+      if (PATH_TABLE[m->g][m->p->v->id] != Solver::NIL &&
+          PATH_TABLE[m->g - 1][m->v->id] == PATH_TABLE[m->g][m->p->v->id])
+        return true;
     }
     return false;
   };
 
   Path path = getPathBySpaceTimeAstar
-    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, getRemainedTime());
+    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, -1, token.get());
   const int path_size = path.size();
   // format
   if (!path.empty() && path_size - 1 > window) path.resize(window + 1);
@@ -144,11 +192,12 @@ void WHCA::setParams(int argc, char* argv[])
   struct option longopts[] = {
       {"window", required_argument, 0, 'w'},
       {"disable-dist-init", no_argument, 0, 'd'},
+      {"reuse", no_argument, 0, 'r'},
       {0, 0, 0, 0},
   };
   optind = 1;  // reset
   int opt, longindex;
-  while ((opt = getopt_long(argc, argv, "w:d", longopts, &longindex)) != -1) {
+  while ((opt = getopt_long(argc, argv, "w:dr", longopts, &longindex)) != -1) {
     switch (opt) {
       case 'w':
         window = std::atoi(optarg);
@@ -158,6 +207,9 @@ void WHCA::setParams(int argc, char* argv[])
       case 'd':
         disable_dist_init = true;
         break;
+      case 'r':
+        reuse = true;
+        break;
       default:
         break;
     }
@@ -171,5 +223,9 @@ void WHCA::printHelp()
             << "window size\n"
             << "  -d --disable-dist-init        "
             << "disable initialization of priorities "
-            << "using distance from starts to goals" << std::endl;
+            << "using distance from starts to goals\n"
+            << "  -r --reuse                    "
+            << "keep paths of agents resting at goals,\n"
+            << "                                "
+            << "agents on the way are replanned in every window" << std::endl;
 }
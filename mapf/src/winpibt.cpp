@@ -6,7 +6,9 @@ winPIBT::winPIBT(Problem* _P)
     : Solver(_P),
       window(5),
       occupied_t(G->getNodesSize(), NIL),
-      occupied_a(G->getNodesSize(), NIL)
+      occupied_a(G->getNodesSize(), NIL),
+      table_goals(G->getNodesSize(), false),
+      search_id(0)
 {
   solver_name = winPIBT::SOLVER_NAME + "-" + std::to_string(window);
 }
@@ -22,7 +24,10 @@ void winPIBT::run()
     paths.push_back({s});
     occupied_t[s->id] = 0;
     occupied_a[s->id] = i;
+    table_goals[P->getGoal(i)->id] = true;
   }
+  // distance from the last location to the goal
+  std::vector<int> priorities(P->getNum(), 0);
 
   // the maximum length of paths
   int max_len = 0;
@@ -31,11 +36,14 @@ void winPIBT::run()
   while (true) {
     if (overCompTime() || max_len > max_timestep) return;
 
-    // far agent is prioritized
-    std::sort(ids.begin(), ids.end(), [&](int a, int b) {
-      return pathDist(a, *(paths[a].end() - 1)) >
-             pathDist(b, *(paths[b].end() - 1));
-    });
+    // far agent is prioritized, sort only when the order changes
+    for (int i = 0; i < P->getNum(); ++i) {
+      priorities[i] = pathDist(i, *(paths[i].end() - 1));
+    }
+    auto compare = [&](int a, int b) { return priorities[a] > priorities[b]; };
+    if (!std::is_sorted(ids.begin(), ids.end(), compare)) {
+      std::sort(ids.begin(), ids.end(), compare);
+    }
 
     for (int j = 0; j < P->getNum(); ++j) {
       const int i = ids[j];
@@ -47,7 +55,8 @@ void winPIBT::run()
            ", agent-" + std::to_string(i), "starts planning at t=", buf);
 
       // get single path
-      Path path = getSinglePath(i, paths);
+      Path& path = path_buf;
+      getSinglePath(i, paths, path);
       if (path.empty()) {
         info(" ", "failed to find path");
         return;  // failed
@@ -77,7 +86,8 @@ void winPIBT::run()
             if (!funcPIBT(k, paths, v_next, v_now)) {
               info("  ", "failed, replanning");
               // replanning
-              auto p = getSinglePath(i, paths);
+              auto& p = replan_buf;
+              getSinglePath(i, paths, p);
               if (p.empty()) {
                 info("  ", "failed to replan the path");
                 return;
@@ -175,7 +185,8 @@ Node* winPIBT::chooseNode(const int id, std::vector<Path>& paths,
 {
   const int t = paths[id].size() - 1;
   Node* v_now = paths[id][t];
-  Nodes C = v_now->neighbor;
+  C.clear();
+  C.insert(C.end(), v_now->neighbor.begin(), v_now->neighbor.end());
   C.push_back(v_now);
 
   // randomize
@@ -204,37 +215,87 @@ Node* winPIBT::chooseNode(const int id, std::vector<Path>& paths,
   return v;
 }
 
-Path winPIBT::getSinglePath(const int id, std::vector<Path>& paths)
+void winPIBT::getSinglePath(const int id, std::vector<Path>& paths, Path& path)
 {
+  path.clear();
   auto g = P->getGoal(id);
   auto s = *(paths[id].end() - 1);
   const int buf = paths[id].size() - 1;
-  AstarHeuristics fValue = [&](AstarNode* n) {
-    return n->g + pathDist(id, n->v);
-  };
-  CheckAstarFin checkAstarFin = [&](AstarNode* n) {
-    return n->v == g || n->g >= window;
-  };
+  CancelPoller poller(token.get());
 
-  Nodes config_g = P->getConfigGoal();
-  CompareAstarNode compare = [&](AstarNode* a, AstarNode* b) {
+  auto compare = [&](const int i, const int j) {
+    auto& a = search_nodes[i];
+    auto& b = search_nodes[j];
     // usual f-value
-    if (a->f != b->f) return a->f > b->f;
+    if (a.f != b.f) return a.f > b.f;
     // tie-break, avoid goal locations of others
-    if (a->v != g && inArray(a->v, config_g)) return true;
-    if (b->v != g && inArray(b->v, config_g)) return false;
+    if (a.v != g && table_goals[a.v->id]) return true;
+    if (b.v != g && table_goals[b.v->id]) return false;
     // usual g-value
-    if (a->g != b->g) return a->g < b->g;
+    if (a.g != b.g) return a.g < b.g;
     return false;
   };
 
-  CheckInvalidAstarNode checkInvalidAstarNode = [&](AstarNode* m) {
-    // future and vertex conflict
-    if (occupied_t[m->v->id] >= m->g + buf) return true;
-    return false;
+  // closed list, rows are allocated only once
+  ++search_id;
+  auto isClosed = [&](Node* v, const int t) {
+    return t < (int)closed_id.size() && closed_id[t][v->id] == search_id;
+  };
+  auto setClosed = [&](Node* v, const int t) {
+    while ((int)closed_id.size() <= t) {
+      closed_id.emplace_back(G->getNodesSize(), NIL);
+    }
+    closed_id[t][v->id] = search_id;
+  };
+
+  // OPEN list
+  search_nodes.clear();
+  open_list.clear();
+  auto push = [&](Node* v, const int t, const int parent) {
+    search_nodes.push_back({v, t, t + pathDist(id, v), parent});
+    open_list.push_back(search_nodes.size() - 1);
+    std::push_heap(open_list.begin(), open_list.end(), compare);
   };
-  return getPathBySpaceTimeAstar
-    (s, g, fValue, compare, checkAstarFin, checkInvalidAstarNode, getRemainedTime());
+  push(s, 0, NIL);
+
+  // main loop
+  int k = NIL;
+  while (!open_list.empty()) {
+    // check time limit and cancellation
+    if (poller.stop()) break;
+
+    // minimum node
+    std::pop_heap(open_list.begin(), open_list.end(), compare);
+    const int n = open_list.back();
+    open_list.pop_back();
+    Node* v = search_nodes[n].v;
+    const int t = search_nodes[n].g;
+
+    // check CLOSE list
+    if (isClosed(v, t)) continue;
+    setClosed(v, t);
+
+    // check goal condition
+    if (v == g || (window != -1 && t >= window)) {
+      k = n;
+      break;
+    }
+
+    // expand
+    auto expand = [&](Node* u) {
+      // already searched?
+      if (isClosed(u, t + 1)) return;
+      // future and vertex conflict
+      if (occupied_t[u->id] >= t + 1 + buf) return;
+      push(u, t + 1, n);
+    };
+    for (auto u : v->neighbor) expand(u);
+    expand(v);
+  }
+
+  // backtrack
+  for (; k != NIL; k = search_nodes[k].p) path.push_back(search_nodes[k].v);
+  std::reverse(path.begin(), path.end());
 }
 
 void winPIBT::setParams(int argc, char* argv[])
@@ -0,0 +1,103 @@
+/*
+ * Load-time benchmark of instance files
+ *
+ * usage: ./bench_problem [-n REPEAT] INSTANCE...
+ *
+ * Each instance is loaded REPEAT times with a shared graph table,
+ * so that the time is dominated by the instance parser, not the map.
+ * Instances with random_problem=1 also include generating starts and goals.
+ * The regex scanner used before the single-pass tokenizer is kept here
+ * as the reference.
+ */
+
+#include <problem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <regex>
+
+// reference, the former regex parser without building the problem
+static int scanByRegex(const std::string& instance)
+{
+  std::ifstream file(instance);
+  std::string line;
+  std::smatch results;
+  std::regex r_comment = std::regex(R"(#.+)");
+  std::regex r_map = std::regex(R"(map_file=(.+))");
+  std::regex r_agents = std::regex(R"(agents=(\d+))");
+  std::regex r_seed = std::regex(R"(seed=(\d+))");
+  std::regex r_random_problem = std::regex(R"(random_problem=(\d+))");
+  std::regex r_well_formed = std::regex(R"(well_formed=(\d+))");
+  std::regex r_max_timestep = std::regex(R"(max_timestep=(\d+))");
+  std::regex r_max_comp_time = std::regex(R"(max_comp_time=(\d+))");
+  std::regex r_sg = std::regex(R"((\d+),(\d+),(\d+),(\d+))");
+
+  int cnt = 0;
+  while (getline(file, line)) {
+    if (!line.empty() && *(line.end() - 1) == 0x0d) line.pop_back();
+    if (std::regex_match(line, results, r_comment)) continue;
+    if (std::regex_match(line, results, r_map)) continue;
+    if (std::regex_match(line, results, r_agents)) continue;
+    if (std::regex_match(line, results, r_seed)) continue;
+    if (std::regex_match(line, results, r_random_problem)) continue;
+    if (std::regex_match(line, results, r_well_formed)) continue;
+    if (std::regex_match(line, results, r_max_timestep)) continue;
+    if (std::regex_match(line, results, r_max_comp_time)) continue;
+    if (std::regex_match(line, results, r_sg)) {
+      cnt += std::stoi(results[1].str()) + std::stoi(results[2].str()) +
+             std::stoi(results[3].str()) + std::stoi(results[4].str());
+    }
+  }
+  return cnt;
+}
+
+template <typename F>
+static double measure(const int repeat, F f)
+{
+  const auto t_start = Time::now();
+  for (int i = 0; i < repeat; ++i) f();
+  const auto t = std::chrono::duration_cast<std::chrono::microseconds>(
+      Time::now() - t_start);
+  return (double)t.count() / 1000 / repeat;  // ms
+}
+
+int main(int argc, char* argv[])
+{
+  int repeat = 10;
+  std::vector<std::string> instances;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (arg == "-n" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+    } else {
+      instances.push_back(arg);
+    }
+  }
+  if (instances.empty()) {
+    std::cout << "usage: " << argv[0] << " [-n REPEAT] INSTANCE..."
+              << std::endl;
+    return 0;
+  }
+
+  for (auto& instance : instances) {
+    GraphTable graphs;
+    int num_agents = 0;
+    // load the map in advance
+    try {
+      num_agents = Problem(instance, &graphs).getNum();
+    } catch (const MAPFError& e) {
+      std::cout << e.what() << std::endl;
+      continue;
+    }
+    const double t_tokenizer =
+        measure(repeat, [&] { Problem P(instance, &graphs); });
+    const double t_regex = measure(repeat, [&] { scanByRegex(instance); });
+    std::cout << instance << ", agents=" << num_agents
+              << ", tokenizer=" << t_tokenizer << "ms"
+              << ", regex=" << t_regex << "ms" << std::endl;
+  }
+  return 0;
+}
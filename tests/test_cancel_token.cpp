@@ -0,0 +1,61 @@
+#include <cancel_token.hpp>
+#include <ecbs.hpp>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(CancelToken, hierarchy)
+{
+  auto root = std::make_shared<CancelToken>();
+  ASSERT_FALSE(root->hasDeadline());
+  ASSERT_EQ(root->getRemainedTime(), -1);
+
+  // the earlier deadline is used
+  const auto now = Time::now();
+  auto parent = std::make_shared<CancelToken>(
+      root, now + std::chrono::milliseconds(1000));
+  auto child = std::make_shared<CancelToken>(
+      parent, now + std::chrono::milliseconds(100000));
+  ASSERT_TRUE(child->getDeadline() == parent->getDeadline());
+  ASSERT_LE(child->getRemainedTime(), 1000);
+  ASSERT_FALSE(child->isExpired());
+  ASSERT_TRUE(child->isExpired(now + std::chrono::milliseconds(1000)));
+
+  // cancelling a child does not stop the parent
+  auto sibling = std::make_shared<CancelToken>(parent);
+  child->cancel();
+  ASSERT_TRUE(child->isCancelled());
+  ASSERT_FALSE(parent->isCancelled());
+  ASSERT_FALSE(sibling->isCancelled());
+
+  // cancelling the root stops all
+  root->cancel();
+  ASSERT_TRUE(parent->isCancelled());
+  ASSERT_TRUE(sibling->isExpired());
+}
+
+TEST(CancelToken, poller)
+{
+  CancelToken token;
+  CancelPoller poller(&token);
+  token.cancel();
+  // the token is read once in a while
+  bool stopped = false;
+  for (int i = 0; i < 1000 && !stopped; ++i) stopped = poller.stop();
+  ASSERT_TRUE(stopped);
+}
+
+TEST(CancelToken, stop_solver)
+{
+  // ECBS cannot solve it within the time limit
+  Problem P = Problem("../tests/instances/tunnel.txt");
+  P.setMaxCompTime(60000);
+  ECBS solver(&P);
+  std::thread th([&] { solver.solve(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  P.interrupt();
+  th.join();
+
+  ASSERT_FALSE(solver.succeed());
+  ASSERT_LT(solver.getCompTime(), 10000);
+}
@@ -1,4 +1,5 @@
 #include <icbs.hpp>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -12,3 +13,20 @@ TEST(ICBS, solve)
   ASSERT_TRUE(solver->getSolution().validate(&P));
   ASSERT_EQ(solver->getSolution().getSOC(), 635);
 }
+
+TEST(ICBS, solve_concurrently)
+{
+  // solver instances are independent
+  Problem P1 = Problem("../tests/instances/example.txt");
+  Problem P2 = Problem("../tests/instances/example.txt");
+  auto solver1 = ICBS(&P1);
+  auto solver2 = ICBS(&P2);
+  std::thread th([&]() { solver1.solve(); });
+  solver2.solve();
+  th.join();
+
+  ASSERT_TRUE(solver1.succeed());
+  ASSERT_TRUE(solver2.succeed());
+  ASSERT_EQ(solver1.getSolution().getSOC(), 635);
+  ASSERT_EQ(solver2.getSolution().getSOC(), 635);
+}
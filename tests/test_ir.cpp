@@ -1,7 +1,44 @@
+#include <cstring>
+#include <numeric>
+#include <fstream>
 #include <ir.hpp>
+#include <pp_refine.hpp>
 
 #include "gtest/gtest.h"
 
+// plan from locations of each agent
+static Plan makePlan(Graph* G,
+                     const std::vector<std::vector<std::tuple<int, int>>>& locs)
+{
+  Paths paths(locs.size());
+  for (int i = 0; i < (int)locs.size(); ++i) {
+    Path path;
+    for (auto& [x, y] : locs[i]) path.push_back(G->getNode(x, y));
+    paths.insert(i, path);
+  }
+  return Solver::pathsToPlan(paths);
+}
+
+// exposes the memo of neighborhoods
+class IR_MEMO : public IR
+{
+public:
+  IR_MEMO(Problem* _P) : IR(_P) {}
+  size_t getFingerprint(const Plan& plan, const std::vector<int>& modif_list)
+  {
+    std::vector<int> A(P->getNum());
+    std::iota(A.begin(), A.end(), 0);
+    reserved = ReservationTable(plan, A);
+    return getNeighborhoodFingerprint(plan, modif_list);
+  }
+  // whether a result is skipped next time
+  bool memorize(const bool improved, const bool timeout)
+  {
+    memorizeNeighborhood("a", 0, improved, timeout);
+    return isFailedNeighborhood("a", 0);
+  }
+};
+
 TEST(LibIR, identifyInteractingSetByMDD)
 {
   Problem P = Problem("../tests/instances/libir_mdd.txt");
@@ -101,6 +138,159 @@ TEST(libIR, identifyBottleneckAgents)
   ASSERT_EQ(std::get<1>(res1).size(), 2);
 }
 
+TEST(libIR, commitImprovements)
+{
+  Grid G("8x8.map");
+
+  // a0 detours, a1 and a2 wait
+  const Plan plan = makePlan(
+      &G, {{{0, 0}, {0, 1}, {0, 2}, {0, 3}, {1, 3}, {2, 3}, {2, 2}, {2, 1},
+            {2, 0}},
+           {{1, 2}, {1, 2}, {1, 2}, {1, 2}, {1, 1}, {1, 0}},
+           {{5, 5}, {5, 6}, {6, 6}, {7, 6}, {7, 5}}});
+  ASSERT_EQ(plan.getSOC(), 17);
+
+  // each avoids the old paths, but a0 and a1 collide at (1, 0)
+  const std::vector<std::vector<int>> modif_lists = {{0}, {1}, {2}};
+  const std::vector<Plan> sub_plans = {
+      makePlan(&G, {{{0, 0}, {0, 0}, {1, 0}, {2, 0}}}),  // improvement: 5
+      makePlan(&G, {{{1, 2}, {1, 1}, {1, 0}}}),          // improvement: 3
+      makePlan(&G, {{{5, 5}, {6, 5}, {7, 5}}})};         // improvement: 2
+  const auto res = IR::commitImprovements(plan, modif_lists, sub_plans);
+  const auto& merged = std::get<0>(res);
+  ASSERT_EQ(std::get<1>(res), std::vector<int>({0, 2}));
+  ASSERT_EQ(std::get<2>(res), std::vector<int>({1}));
+  ASSERT_EQ(merged.getSOC(), 3 + 5 + 2);
+  ASSERT_EQ(merged.getPathCost(1), plan.getPathCost(1));
+  ASSERT_TRUE(merged.validate(plan.get(0), plan.last()));
+
+  // failures and no improvement are ignored
+  const auto res_none = IR::commitImprovements(
+      plan, modif_lists,
+      {Plan(), sub_plans[1], makePlan(&G, {{{5, 5}, {5, 6}, {6, 6}, {7, 6},
+                                             {7, 5}}})});
+  ASSERT_EQ(std::get<1>(res_none), std::vector<int>({1}));
+  ASSERT_TRUE(std::get<2>(res_none).empty());
+}
+
+TEST(PP_REFINE, agent_at_goal)
+{
+  Grid G("8x8.map");
+  Node* a = G.getNode(0, 0);
+  Node* b = G.getNode(1, 0);
+  Node* c = G.getNode(2, 0);
+  Problem P = Problem(&G, {c, a}, {c, b}, 1000, 10);
+
+  // a0 stays at its goal, a1 waits once
+  Plan plan;
+  plan.add({c, a});
+  plan.add({c, a});
+  plan.add({c, b});
+  ASSERT_TRUE(plan.validate(&P));
+  ASSERT_EQ(plan.getSOC(), 2);
+
+  // no slack for a0, its cost-0 path must be accepted
+  const std::vector<int> ignored = {0, 1};
+  ReservationTable reserved(plan, ignored);
+  auto solver = PP_REFINE(&P, plan, &reserved, ignored);
+  solver.solve();
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+  ASSERT_EQ(solver.getSolution().getSOC(), 1);
+}
+
+TEST(libIR, neighborhoodFingerprint)
+{
+  Grid G("8x8.map");
+  Problem P = Problem(&G, {G.getNode(0, 0), G.getNode(1, 3), G.getNode(7, 7)},
+                      {G.getNode(3, 0), G.getNode(1, 1), G.getNode(7, 5)},
+                      1000, 10);
+  auto solver = IR_MEMO(&P);
+  solver.createDistanceTable();
+
+  // budget of a0 is five, a1 reaches (1, 1) within the window of a0
+  const std::vector<std::tuple<int, int>> path0 = {
+      {0, 0}, {0, 0}, {0, 0}, {1, 0}, {2, 0}, {3, 0}};
+  const Plan plan =
+      makePlan(&G, {path0, {{1, 3}, {1, 2}, {1, 1}}, {{7, 7}, {7, 6}, {7, 5}}});
+  ASSERT_TRUE(plan.validate(&P));
+  const auto fingerprint = solver.getFingerprint(plan, {0});
+
+  // far agents do not matter
+  const Plan plan_far = makePlan(
+      &G, {path0, {{1, 3}, {1, 2}, {1, 1}},
+           {{7, 7}, {6, 7}, {6, 6}, {6, 5}, {7, 5}}});
+  ASSERT_TRUE(plan_far.validate(&P));
+  ASSERT_EQ(solver.getFingerprint(plan_far, {0}), fingerprint);
+
+  // overlapping agents invalidate the entry
+  const Plan plan_near = makePlan(
+      &G, {path0, {{1, 3}, {1, 3}, {1, 2}, {1, 1}}, {{7, 7}, {7, 6}, {7, 5}}});
+  ASSERT_TRUE(plan_near.validate(&P));
+  ASSERT_NE(solver.getFingerprint(plan_near, {0}), fingerprint);
+
+  // paths of the neighborhood itself
+  const Plan plan_self = makePlan(
+      &G, {{{0, 0}, {0, 0}, {1, 0}, {1, 0}, {2, 0}, {3, 0}},
+           {{1, 3}, {1, 2}, {1, 1}},
+           {{7, 7}, {7, 6}, {7, 5}}});
+  ASSERT_TRUE(plan_self.validate(&P));
+  ASSERT_NE(solver.getFingerprint(plan_self, {0}), fingerprint);
+}
+
+TEST(IR, memo)
+{
+  // the whole neighborhood is refined repeatedly by deterministic CBS
+  Problem P = Problem("../tests/instances/libir_bottleneck.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-y", (char*)"CBS", (char*)"-S",
+                  (char*)"2", (char*)"-n", (char*)"5"};
+  solver.setParams(7, argv);
+  solver.solve();
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+  ASSERT_GT(solver.getSkippedNum(), 0);
+
+  // ICBS, the default, is optimal, only the returned plan is random
+  auto solver_icbs = IR(&P);
+  argv[2] = (char*)"ICBS";
+  solver_icbs.setParams(7, argv);
+  solver_icbs.solve();
+  ASSERT_TRUE(solver_icbs.succeed());
+  ASSERT_GT(solver_icbs.getSkippedNum(), 0);
+
+  // PP depends on random orders
+  auto solver_pp = IR(&P);
+  argv[2] = (char*)"PP";
+  solver_pp.setParams(7, argv);
+  solver_pp.solve();
+  ASSERT_TRUE(solver_pp.succeed());
+  ASSERT_EQ(solver_pp.getSkippedNum(), 0);
+}
+
+TEST(IR, memo_timeout)
+{
+  Problem P = Problem("../tests/instances/libir_bottleneck.txt");
+  auto solver = IR_MEMO(&P);
+  // time-limited failures might improve with more time
+  ASSERT_FALSE(solver.memorize(false, true));
+  ASSERT_TRUE(solver.memorize(false, false));
+  ASSERT_FALSE(solver.memorize(true, false));
+}
+
+TEST(IR, memo_parallel)
+{
+  Problem P = Problem("../tests/instances/libir_bottleneck.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-y", (char*)"CBS", (char*)"-S",
+                  (char*)"1", (char*)"-j", (char*)"2", (char*)"-n", (char*)"5"};
+  solver.setParams(9, argv);
+  solver.solve();
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+  ASSERT_GT(solver.getSkippedNum(), 0);
+}
+
 TEST(IR, solve)
 {
   Problem P = Problem("../tests/instances/example.txt");
@@ -111,6 +301,129 @@ TEST(IR, solve)
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
 
+TEST(IR, solve_parallel)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-j", (char*)"3", (char*)"-S", (char*)"5"};
+  solver.setParams(5, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(IR, solve_pp)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-y", (char*)"PP", (char*)"-S", (char*)"20"};
+  solver.setParams(5, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(IR, solve_ecbs)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-y", (char*)"ECBS", (char*)"-Y", (char*)"-w 1.5"};
+  solver.setParams(5, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(IR, solver_options)
+{
+  // tokens of -X and -Y are split independently
+  class IR_OPTIONS : public IR
+  {
+  public:
+    IR_OPTIONS(Problem* _P) : IR(_P) {}
+    std::vector<std::string> getInitOptions() { return option_init_solver; }
+    std::vector<std::string> getRefineOptions() { return option_optimal_solver; }
+  };
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = IR_OPTIONS(&P);
+  char* argv[] = {(char*)"", (char*)"-X", (char*)"a", (char*)"-Y",
+                  (char*)"-w 1.5"};
+  solver.setParams(5, argv);
+  ASSERT_EQ(solver.getInitOptions(), std::vector<std::string>({"a"}));
+  ASSERT_EQ(solver.getRefineOptions(),
+            std::vector<std::string>({"-w", "1.5"}));
+}
+
+TEST(IR, solve_fallback)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-F", (char*)"-t", (char*)"1", (char*)"-S", (char*)"20"};
+  solver.setParams(6, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(IR, solve_portfolio)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-x", (char*)"PIBT_COMPLETE,ECBS,HCA"};
+  solver.setParams(3, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(IR, stream)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto G = P.getG();
+  auto solver = IR(&P);
+  char* argv[] = {(char*)"", (char*)"-L", (char*)"./test_ir_stream.txt"};
+  solver.setParams(3, argv);
+  solver.solve();
+  ASSERT_TRUE(solver.succeed());
+
+  // replay the records
+  std::ifstream file("./test_ir_stream.txt");
+  std::vector<Path> paths(P.getNum());
+  std::string line;
+  int records = 0;
+  bool ended = false;
+  while (std::getline(file, line)) {
+    if (line.find("iter=") == 0) ++records;
+    if (line == "end") ended = true;
+    const auto pos = line.find(":");
+    if (pos == std::string::npos || line.find("=") != std::string::npos) {
+      continue;
+    }
+    const int id = std::stoi(line.substr(0, pos));
+    paths[id].clear();
+    int x, y;
+    for (auto p = line.c_str() + pos + 1;
+         std::sscanf(p, "(%d,%d),", &x, &y) == 2; p = std::strchr(p, ')') + 2) {
+      paths[id].push_back(G->getNode(x, y));
+    }
+  }
+  ASSERT_TRUE(ended);
+  ASSERT_GE(records, 1);
+
+  const auto solution = solver.getSolution();
+  for (int i = 0; i < P.getNum(); ++i) {
+    ASSERT_EQ((int)paths[i].size() - 1, solution.getPathCost(i));
+    for (int t = 0; t < (int)paths[i].size(); ++t) {
+      ASSERT_EQ(paths[i][t], solution.get(t, i));
+    }
+  }
+}
+
 TEST(IR_SINGLE_PATHS, solve)
 {
   Problem P = Problem("../tests/instances/ir_single_paths.txt");
@@ -196,3 +509,67 @@ TEST(IR_HYBRID, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(IR_ADAPTIVE, solve)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  std::unique_ptr<Solver> solver = std::make_unique<IR_ADAPTIVE>(&P);
+  solver->solve();
+
+  ASSERT_TRUE(solver->succeed());
+  ASSERT_TRUE(solver->getSolution().validate(&P));
+}
+
+TEST(IR_ADAPTIVE, weights)
+{
+  std::mt19937 MT(0);
+
+  // weights follow rewards, rules paying off gain weights
+  std::vector<double> weights(3, 1.0);
+  for (int k = 0; k < 50; ++k) {
+    IR_ADAPTIVE::updateWeight(weights[0], 0);
+    IR_ADAPTIVE::updateWeight(weights[1], 5.0);
+    IR_ADAPTIVE::updateWeight(weights[2], 0.5);
+  }
+  ASSERT_NEAR(weights[0], 0, 1e-3);
+  ASSERT_NEAR(weights[1], 5.0, 1e-3);
+  ASSERT_NEAR(weights[2], 0.5, 1e-3);
+
+  // roulette prefers heavy weights, others are still explored
+  std::vector<int> cnts(3, 0);
+  for (int k = 0; k < 1000; ++k) {
+    ++cnts[IR_ADAPTIVE::selectByRoulette(weights, &MT)];
+  }
+  ASSERT_GT(cnts[1], cnts[2]);
+  ASSERT_GT(cnts[2], cnts[0]);
+  ASSERT_GT(cnts[0], 0);
+  ASSERT_GT(cnts[1], 800);
+
+  // all zero -> uniform
+  std::vector<int> cnts_zero(3, 0);
+  for (int k = 0; k < 300; ++k) {
+    ++cnts_zero[IR_ADAPTIVE::selectByRoulette({0, 0, 0}, &MT)];
+  }
+  for (auto c : cnts_zero) ASSERT_GT(c, 50);
+}
+
+TEST(IR_ADAPTIVE, max_iteration)
+{
+  Problem P = Problem("../tests/instances/libir_mdd_advanced.txt");
+  auto solver = IR_ADAPTIVE(&P);
+  char* argv[] = {(char*)"", (char*)"-n", (char*)"3"};
+  solver.setParams(3, argv);
+  solver.setVerbose(true);
+  testing::internal::CaptureStdout();
+  solver.solve();
+  const std::string output = testing::internal::GetCapturedStdout();
+  ASSERT_TRUE(solver.succeed());
+
+  // each scheduled rule counts, whether or not it updates the solution
+  int steps = 0;
+  for (auto pos = output.find("rule:"); pos != std::string::npos;
+       pos = output.find("rule:", pos + 1)) {
+    ++steps;
+  }
+  ASSERT_LE(steps, 3);
+}
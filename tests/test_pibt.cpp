@@ -11,3 +11,26 @@ TEST(PIBT, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(PIBT, step)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = PIBT(&P);
+  solver.solve();
+  auto solution = solver.getSolution();
+
+  // same seed, same plan
+  Problem Q = Problem(P.getG(), P.getConfigStart(), P.getConfigGoal(),
+                      P.getMaxCompTime(), P.getMaxTimestep());
+  auto stepper = PIBT(&Q);
+  stepper.createDistanceTable();
+  stepper.initSteps();
+  Config config = Q.getConfigStart();
+  Config next(Q.getNum(), nullptr);
+  for (int t = 1; t <= solution.getMakespan(); ++t) {
+    stepper.step(config, next);
+    ASSERT_TRUE(sameConfig(next, solution.get(t)));
+    std::swap(config, next);
+  }
+  ASSERT_TRUE(sameConfig(config, Q.getConfigGoal()));
+}
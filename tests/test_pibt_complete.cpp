@@ -11,3 +11,39 @@ TEST(PIBT_COMPLETE, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(PIBT_COMPLETE, race)
+{
+  // ECBS alone cannot complement the plan in time
+  Problem P = Problem("../tests/instances/tunnel.txt");
+  auto solver = PIBT_COMPLETE(&P);
+  char* argv[] = {(char*)"", (char*)"-x", (char*)"PushAndSwap,ECBS"};
+  solver.setParams(3, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(PIBT_COMPLETE, loop_chain)
+{
+  // PushAndSwap fails to resolve, an agent at its goal blocks the others
+  Problem P = Problem("../tests/instances/loop-chain.txt");
+  auto solver = PIBT_COMPLETE(&P);
+  char* argv[] = {(char*)"", (char*)"-x", (char*)"PushAndSwap"};
+  solver.setParams(3, argv);
+  solver.solve();
+  ASSERT_FALSE(solver.succeed());
+}
+
+TEST(PIBT_COMPLETE, loop_chain_without_plan)
+{
+  // ECBS fails without any plan
+  Problem P = Problem("../tests/instances/loop-chain.txt");
+  P.setMaxCompTime(100);
+  auto solver = PIBT_COMPLETE(&P);
+  char* argv[] = {(char*)"", (char*)"-x", (char*)"ECBS"};
+  solver.setParams(3, argv);
+  solver.solve();
+  ASSERT_FALSE(solver.succeed());
+}
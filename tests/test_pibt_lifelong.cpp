@@ -0,0 +1,75 @@
+#include <pibt_lifelong.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(PIBT_LIFELONG, solve)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = PIBT_LIFELONG(&P);
+  solver.solve();
+
+  // random tasks until max_timestep
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.validateSolution());
+  ASSERT_EQ(solver.getSolution().getMakespan(), P.getMaxTimestep());
+  ASSERT_GT(solver.getTasksCompleted(), P.getNum());
+}
+
+TEST(PIBT_LIFELONG, task_file)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = PIBT_LIFELONG(&P);
+  char* argv[] = {(char*)"", (char*)"-f",
+                  (char*)"../tests/instances/lifelong_tasks.txt"};
+  solver.setParams(3, argv);
+  solver.solve();
+
+  // initial goals and all tasks are completed
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.validateSolution());
+  ASSERT_EQ(solver.getTasksCompleted(), P.getNum() + 20);
+}
+
+TEST(PIBT_LIFELONG, horizon_window)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  {
+    // longer than max_timestep of the instance
+    auto solver = PIBT_LIFELONG(&P);
+    char* argv[] = {(char*)"", (char*)"-H", (char*)"300"};
+    solver.setParams(3, argv);
+    solver.solve();
+    ASSERT_TRUE(solver.succeed());
+    ASSERT_TRUE(solver.validateSolution());
+    ASSERT_EQ(solver.getTimesteps(), 300);
+    ASSERT_EQ(solver.getSolution().getMakespan(), 300);
+  }
+  {
+    // unlimited, stopped by the time limit, only the latest configurations
+    P.setMaxCompTime(200);
+    auto solver = PIBT_LIFELONG(&P);
+    char* argv[] = {(char*)"", (char*)"-H", (char*)"0", (char*)"-w",
+                    (char*)"50"};
+    solver.setParams(5, argv);
+    solver.solve();
+    ASSERT_TRUE(solver.succeed());
+    ASSERT_TRUE(solver.validateSolution());
+    ASSERT_GT(solver.getTimesteps(), P.getMaxTimestep());
+    ASSERT_EQ(solver.getSolution().size(), 50);
+  }
+}
+
+TEST(PIBT_LIFELONG, random_goals_in_components)
+{
+  // two rooms and an isolated cell
+  Problem P = Problem("../tests/instances/two-rooms.txt");
+  auto solver = PIBT_LIFELONG(&P);
+  solver.solve();
+
+  // random goals are reachable, otherwise agents get stuck
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.validateSolution());
+  ASSERT_GT(solver.getTasksCompleted(), 100);
+  // no task for the isolated agent
+  ASSERT_EQ(solver.getSolution().last(3), P.getStart(3));
+}
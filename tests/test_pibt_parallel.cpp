@@ -0,0 +1,40 @@
+#include <pibt_parallel.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(PIBT_PARALLEL, solve)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  std::unique_ptr<Solver> solver = std::make_unique<PIBT_PARALLEL>(&P);
+  solver->solve();
+
+  ASSERT_TRUE(solver->succeed());
+  ASSERT_TRUE(solver->getSolution().validate(&P));
+}
+
+TEST(PIBT_PARALLEL, threads)
+{
+  // the plan does not depend on the number of threads
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver1 = PIBT_PARALLEL(&P);
+  char* argv1[] = {(char*)"", (char*)"-r", (char*)"3", (char*)"-j", (char*)"1"};
+  solver1.setParams(5, argv1);
+  solver1.solve();
+
+  Problem Q = Problem("../tests/instances/example.txt");
+  auto solver2 = PIBT_PARALLEL(&Q);
+  char* argv2[] = {(char*)"", (char*)"-r", (char*)"3", (char*)"-j", (char*)"3"};
+  solver2.setParams(5, argv2);
+  solver2.solve();
+
+  ASSERT_TRUE(solver1.succeed());
+  ASSERT_TRUE(solver2.succeed());
+  auto sol1 = solver1.getSolution();
+  auto sol2 = solver2.getSolution();
+  ASSERT_EQ(sol1.getMakespan(), sol2.getMakespan());
+  for (int t = 0; t <= sol1.getMakespan(); ++t) {
+    for (int i = 0; i < P.getNum(); ++i) {
+      ASSERT_EQ(sol1.get(t, i)->id, sol2.get(t, i)->id);
+    }
+  }
+}
@@ -69,6 +69,33 @@ TEST(Plan, add)
   ASSERT_EQ(plan1.getMakespan(), 1);
   plan1 += plan2;
   ASSERT_EQ(plan1.getMakespan(), 2);
+  ASSERT_EQ(plan1.getSOC(), 2);
+}
+
+TEST(Plan, cost)
+{
+  Grid G("8x8.map");
+  Node* v = G.getNode(0);
+  Node* u = G.getNode(1);
+  Node* w = G.getNode(2);
+
+  Plan plan;
+  plan.add({v, w});
+  plan.add({u, w});
+  plan.add({v, w});
+  plan.add({v, w});
+  ASSERT_EQ(plan.getPathCost(0), 2);  // leave and return to the goal
+  ASSERT_EQ(plan.getPathCost(1), 0);
+  ASSERT_EQ(plan.getSOC(), 2);
+
+  plan.add({v, u});
+  ASSERT_EQ(plan.getPathCost(1), 4);
+  ASSERT_EQ(plan.getSOC(), 6);
+
+  plan.clear();
+  ASSERT_EQ(plan.getSOC(), 0);
+  plan.add({u, v});
+  ASSERT_EQ(plan.getPathCost(0), 0);
 }
 
 TEST(Plan, validate)
@@ -1,5 +1,9 @@
 #include <problem.hpp>
 #include <plan.hpp>
+#include <scenario.hpp>
+
+#include <cstdio>
+#include <fstream>
 
 #include "gtest/gtest.h"
 
@@ -23,6 +27,60 @@ TEST(Problem, loading)
   ASSERT_EQ(goals[1], G->getNode(0, 1));
 }
 
+TEST(Problem, tokenizer)
+{
+  const std::string file = "/tmp/mapf_test_tokenizer.txt";
+  {
+    std::ofstream out(file, std::ios::out | std::ios::binary);
+    out << "#map_file=broken.map\r\n"
+        << "map_file=8x8.map\r\n"
+        << "\r\n"
+        << "agents=2\r\n"
+        << "seed=x\r\n"
+        << "max_timestep=10a\r\n"
+        << "max_comp_time=500\r\n"
+        << "unknown_key=1\r\n"
+        << "1,2,3\r\n"
+        << "1,2,3,4,5\r\n"
+        << "0,0,1,0\r\n"
+        << "2,2,0,1\r\n"
+        << "3,3,3,3";  // no line break at the end, exceeds agents
+  }
+  Problem P = Problem(file);
+  Graph* G = P.getG();
+  ASSERT_EQ(P.getNum(), 2);
+  ASSERT_EQ(P.getMaxTimestep(), DEFAULT_MAX_TIMESTEP);
+  ASSERT_EQ(P.getMaxCompTime(), 500);
+  ASSERT_EQ(P.getStart(0), G->getNode(0, 0));
+  ASSERT_EQ(P.getGoal(0), G->getNode(1, 0));
+  ASSERT_EQ(P.getStart(1), G->getNode(2, 2));
+  ASSERT_EQ(P.getGoal(1), G->getNode(0, 1));
+  std::remove(file.c_str());
+}
+
+TEST(Problem, not_found)
+{
+  ASSERT_THROW(Problem("../tests/instances/not_found.txt"), MAPFError);
+}
+
+TEST(Problem, invalid_instance)
+{
+  const std::string file = "/tmp/mapf_test_invalid.txt";
+  // starts and goals without map
+  {
+    std::ofstream out(file);
+    out << "agents=1\n0,0,1,1\n";
+  }
+  ASSERT_THROW(Problem P(file), MAPFError);
+  // nodes out of the map, the graph and seed are released
+  {
+    std::ofstream out(file);
+    out << "map_file=8x8.map\nseed=1\nagents=1\n0,0,9,9\n";
+  }
+  ASSERT_THROW(Problem P(file), MAPFError);
+  std::remove(file.c_str());
+}
+
 TEST(Problem, plan)
 {
   Problem P = Problem("../tests/instances/toy_problem.txt");
@@ -42,3 +100,57 @@ TEST(Problem, plan)
   plan1.add(c1_1);
   ASSERT_FALSE(plan1.validate(&P));
 }
+
+TEST(Problem, shared_graph)
+{
+  GraphTable graphs;
+  Graph* G;
+  {
+    Problem P1 = Problem("../tests/instances/toy_problem.txt", &graphs);
+    Problem P2 = Problem("../tests/instances/toy_problem.txt", &graphs);
+    G = P1.getG();
+    ASSERT_EQ(G, P2.getG());
+    ASSERT_EQ(graphs.size(), 1);
+  }
+  // graphs remain after the problems
+  ASSERT_EQ(G->getNode(0, 0), graphs.begin()->second->getNode(0, 0));
+}
+
+TEST(Problem, given_graph)
+{
+  Grid G("8x8.map");
+  Problem P = Problem(&G, {G.getNode(0), G.getNode(1)},
+                      {G.getNode(2), G.getNode(3)}, 1000, 10);
+  ASSERT_EQ(P.getNum(), 2);
+  ASSERT_EQ(P.getG(), &G);
+  ASSERT_EQ(P.getGoal(1), G.getNode(3));
+  ASSERT_THROW(Problem(&G, {G.getNode(0)}, {}, 1000, 10), MAPFError);
+}
+
+TEST(Problem, scenario)
+{
+  Scenario scen("../tests/instances/toy.scen");
+  ASSERT_EQ(scen.getMapFileName(), "8x8.map");
+  ASSERT_EQ(scen.getSize(), 3);
+  ASSERT_EQ(scen.getEntry(2).bucket, 1);
+  ASSERT_DOUBLE_EQ(scen.getEntry(1).optimal_length, 1.41421356);
+
+  // problems of different numbers of agents from one scenario
+  GraphTable graphs;
+  Problem P1 = Problem(scen, 1, &graphs);
+  Problem P3 = Problem(scen, 3, &graphs, 1000, 10);
+  Graph* G = P3.getG();
+  ASSERT_EQ(P1.getG(), G);
+  ASSERT_EQ(P1.getNum(), 1);
+  ASSERT_EQ(P3.getNum(), 3);
+  ASSERT_EQ(P3.getMaxTimestep(), 10);
+  ASSERT_EQ(P3.getMaxCompTime(), 1000);
+  ASSERT_EQ(P3.getStart(1), G->getNode(1, 1));
+  ASSERT_EQ(P3.getGoal(1), G->getNode(0, 1));
+  ASSERT_EQ(P3.getStart(2), G->getNode(7, 7));
+  ASSERT_EQ(P3.getGoal(2), G->getNode(3, 4));
+
+  ASSERT_THROW(Problem(scen, 4, &graphs), MAPFError);
+  ASSERT_THROW(Scenario("../tests/instances/toy_problem.txt"), MAPFError);
+  ASSERT_THROW(Scenario("../tests/instances/not_found.scen"), MAPFError);
+}
@@ -2,6 +2,77 @@
 
 #include "gtest/gtest.h"
 
+// state of PushAndSwap is checked around each swap vertex
+class PushAndSwapUndo : public PushAndSwap
+{
+public:
+  PushAndSwapUndo(Problem* _P) : PushAndSwap(_P) {}
+
+  // same as run without compression, all swap vertices are tried
+  // before each swap operation, return the number of failed ones
+  int solveWithChecks()
+  {
+    createDistanceTable();
+    config_now = P->getConfigStart();
+    occupied_now.assign(G->getNodesSize(), NIL);
+    for (int i = 0; i < P->getNum(); ++i) occupied_now[config_now[i]->id] = i;
+    bfs_parents.assign(G->getNodesSize(), NIL);
+    bfs_queue.clear();
+
+    int failed_num = 0;
+    Nodes U;
+    for (int i = 0; i < P->getNum(); ++i) {
+      while (config_now[i] != P->getGoal(i)) {
+        if (push(i, U)) continue;
+        failed_num += trySwapVertices(i);
+        if (!swap(i, U)) return failed_num;
+      }
+      U.push_back(config_now[i]);
+    }
+    solution = getPlan();
+    return failed_num;
+  }
+
+  int trySwapVertices(const int r)
+  {
+    auto p = getShortestPath(r, config_now[r]);
+    if (p.size() <= 1) return 0;
+    const int s = occupied_now[p[1]->id];
+    if (s == NIL) return 0;
+
+    int failed_num = 0;
+    initSwapVertexSearch(config_now[r]);
+    for (Node* v = getNextSwapVertex(); v != nullptr; v = getNextSwapVertex()) {
+      const Config config_before = config_now;
+      const std::vector<int> occupied_before = occupied_now;
+      const int size = moves.size();
+      if (trySwapVertex(v, r, s)) {
+        undoMoves(size);
+      } else {
+        ++failed_num;
+      }
+      EXPECT_EQ(config_now, config_before);
+      EXPECT_EQ(occupied_now, occupied_before);
+      EXPECT_EQ((int)moves.size(), size);
+    }
+    return failed_num;
+  }
+
+  // swap vertices from root in order
+  Nodes getSwapVertices(Node* root)
+  {
+    bfs_parents.assign(G->getNodesSize(), NIL);
+    bfs_queue.clear();
+    initSwapVertexSearch(root);
+    Nodes vertices;
+    for (Node* v = getNextSwapVertex(); v != nullptr; v = getNextSwapVertex()) {
+      vertices.push_back(v);
+    }
+    return vertices;
+  }
+  Path getPath(Node* v) const { return getPathToSwapVertex(v); }
+};
+
 TEST(PushAndSwap, ins_tree)
 {
   Problem P = Problem("../tests/instances/tree.txt");
@@ -61,3 +132,98 @@ TEST(PushAndSwap, ins_connector)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(PushAndSwap, plans_with_swap)
+{
+  // all instances require swap operations
+  for (auto ins : {"tree", "corners", "tunnel", "string", "loop-chain",
+                   "connector"}) {
+    Problem P = Problem("../tests/instances/" + std::string(ins) + ".txt");
+    // compressed
+    auto solver = PushAndSwap(&P);
+    solver.solve();
+    ASSERT_TRUE(solver.succeed()) << ins;
+    ASSERT_TRUE(solver.getSolution().validate(&P)) << ins;
+
+    // event log as it is
+    auto solver_c = PushAndSwap(&P);
+    char* argv[] = {(char*)"", (char*)"-c"};
+    solver_c.setParams(2, argv);
+    solver_c.solve();
+    ASSERT_TRUE(solver_c.succeed()) << ins;
+    ASSERT_TRUE(solver_c.getSolution().validate(&P)) << ins;
+    // one move per timestep
+    ASSERT_GE(solver_c.getSolution().getMakespan(),
+              solver.getSolution().getMakespan())
+        << ins;
+    const Plan plan = solver_c.getSolution();
+    for (int t = 1; t <= plan.getMakespan(); ++t) {
+      int moved = 0;
+      for (int i = 0; i < P.getNum(); ++i) {
+        if (plan.get(t, i) != plan.get(t - 1, i)) ++moved;
+      }
+      ASSERT_EQ(moved, 1) << ins;
+    }
+  }
+}
+
+TEST(PushAndSwap, undo_swap_vertices)
+{
+  int failed_num = 0;
+  for (auto ins : {"tree", "corners", "tunnel", "string", "loop-chain",
+                   "connector", "example"}) {
+    Problem P = Problem("../tests/instances/" + std::string(ins) + ".txt");
+    auto solver = PushAndSwapUndo(&P);
+    failed_num += solver.solveWithChecks();
+    ASSERT_FALSE(::testing::Test::HasFailure()) << ins;
+    ASSERT_TRUE(solver.getSolution().validate(&P)) << ins;
+  }
+  // some swap vertices fail and are canceled
+  ASSERT_GT(failed_num, 0);
+}
+
+TEST(PushAndSwap, resolve_displaced)
+{
+  // the recursive swap in resolve displaces s from the neighbor of its goal
+  Problem P = Problem("../tests/instances/resolve_displaced.txt");
+  for (auto compress : {true, false}) {
+    auto solver = PushAndSwap(&P);
+    char* argv[] = {(char*)"", (char*)"-c"};
+    if (!compress) solver.setParams(2, argv);
+    solver.solve();
+    ASSERT_TRUE(solver.succeed());
+    ASSERT_TRUE(solver.getSolution().validate(&P));
+  }
+}
+
+TEST(PushAndSwap, swap_vertices_order)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  Graph* G = P.getG();
+  auto solver = PushAndSwapUndo(&P);
+  Node* root = P.getStart(0);
+  auto vertices = solver.getSwapVertices(root);
+
+  // all nodes of degree >= 3 in order of path distance
+  int num = 0;
+  for (auto v : G->getV()) {
+    // unreachable -> -1
+    if (v->getDegree() >= 3 && G->pathDist(root, v) >= 0) ++num;
+  }
+  ASSERT_EQ((int)vertices.size(), num);
+  for (int k = 0; k < (int)vertices.size(); ++k) {
+    auto v = vertices[k];
+    ASSERT_GE(v->getDegree(), 3);
+    if (k > 0) {
+      ASSERT_LE(G->pathDist(root, vertices[k - 1]), G->pathDist(root, v));
+    }
+    // shortest path from the root
+    auto p = solver.getPath(v);
+    ASSERT_EQ(p.front(), root);
+    ASSERT_EQ(p.back(), v);
+    ASSERT_EQ((int)p.size() - 1, G->pathDist(root, v));
+    for (int t = 1; t < (int)p.size(); ++t) {
+      ASSERT_TRUE(inArray(p[t - 1], p[t]->neighbor));
+    }
+  }
+}
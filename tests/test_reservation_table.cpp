@@ -0,0 +1,60 @@
+#include <graph.hpp>
+#include <reservation_table.hpp>
+
+#include "gtest/gtest.h"
+
+TEST(ReservationTable, basic)
+{
+  Grid G("8x8.map");
+  Node* v0 = G.getNode(0);
+  Node* v1 = G.getNode(1);
+  Node* v2 = G.getNode(2);
+  Node* v8 = G.getNode(8);
+
+  ReservationTable table;
+  ASSERT_TRUE(table.empty());
+
+  table.add(0, {v0, v1, v2, v2});
+  ASSERT_FALSE(table.empty());
+  ASSERT_EQ(table.getMakespan(), 1);
+  ASSERT_EQ(table.get(0, v0), 0);
+  ASSERT_EQ(table.get(1, v1), 0);
+  ASSERT_EQ(table.get(1, v0), ReservationTable::NIL);
+  ASSERT_EQ(table.get(-1, v0), ReservationTable::NIL);
+  // stay at the goal forever
+  ASSERT_EQ(table.get(1, v2), ReservationTable::NIL);
+  ASSERT_EQ(table.get(2, v2), 0);
+  ASSERT_EQ(table.get(100, v2), 0);
+  ASSERT_EQ(table.getLastReservedTime(v1), 1);
+  ASSERT_EQ(table.getLastReservedTime(v2), ReservationTable::NIL);
+
+  // vertex conflict
+  ASSERT_TRUE(table.isConflicted(v8, v0, 0));
+  ASSERT_FALSE(table.isConflicted(v8, v0, 1));
+  // swap conflict
+  ASSERT_TRUE(table.isConflicted(v1, v0, 1));
+  ASSERT_FALSE(table.isConflicted(v8, v0, 1));
+
+  table.remove(0, {v0, v1, v2, v2});
+  ASSERT_TRUE(table.empty());
+  ASSERT_EQ(table.get(0, v0), ReservationTable::NIL);
+  ASSERT_EQ(table.get(2, v2), ReservationTable::NIL);
+}
+
+TEST(ReservationTable, plan)
+{
+  Grid G("8x8.map");
+  Node* v0 = G.getNode(0);
+  Node* v1 = G.getNode(1);
+  Node* v8 = G.getNode(8);
+  Node* v9 = G.getNode(9);
+
+  Plan plan;
+  plan.add({v0, v8});
+  plan.add({v1, v9});
+
+  ReservationTable table(plan, {1});
+  ASSERT_EQ(table.get(0, v0), ReservationTable::NIL);
+  ASSERT_EQ(table.get(0, v8), 1);
+  ASSERT_EQ(table.get(1, v9), 1);
+}
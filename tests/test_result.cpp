@@ -0,0 +1,55 @@
+#include <pibt.hpp>
+#include <result.hpp>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+static std::string readFile(const std::string& file_name)
+{
+  std::ifstream file(file_name);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+TEST(Result, binary)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = PIBT(&P);
+  solver.solve();
+  solver.makeLog("./test_result.txt");
+  solver.makeLog("./test_result.bin");
+
+  ResultReader reader("./test_result.bin");
+  ASSERT_EQ(reader.getNum(), P.getNum());
+  ASSERT_EQ(reader.getMakespan(), solver.getSolution().getMakespan());
+  for (int i = 0; i < P.getNum(); ++i) {
+    ASSERT_EQ(reader.getConfig(0)[i], P.getStart(i)->id);
+  }
+
+  // same as the text result
+  std::stringstream text;
+  reader.writeText(text);
+  ASSERT_EQ(text.str(), readFile("./test_result.txt"));
+}
+
+TEST(Result, compressed)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = PIBT(&P);
+  solver.solve();
+  solver.makeLog("./test_result.txt");
+  solver.makeLog("./test_result.binz");
+
+  std::stringstream text;
+  ResultReader("./test_result.binz").writeText(text);
+  ASSERT_EQ(text.str(), readFile("./test_result.txt"));
+}
+
+TEST(Result, broken)
+{
+  std::ofstream file("./test_result_broken.bin");
+  file << "MAPF";
+  file.close();
+  ASSERT_THROW(ResultReader("./test_result_broken.bin"), MAPFError);
+}
@@ -26,3 +26,22 @@ TEST(planToPaths, convert)
   ASSERT_EQ(plan2.get(1, 0), u);
   ASSERT_EQ(plan2.get(1, 1), x);
 }
+
+TEST(Solver, distanceCache)
+{
+  Problem P = Problem("../tests/instances/toy_problem.txt");
+  Solver::DistanceCache cache;
+
+  Solver solver1(&P);
+  solver1.setDistanceCache(&cache);
+  solver1.createDistanceTable();
+  ASSERT_EQ(cache.size(), 2);
+
+  // rows are reused by another problem on the same graph
+  Problem Q = Problem(P.getG(), {P.getStart(1)}, {P.getGoal(0)}, 1000, 10);
+  Solver solver2(&Q);
+  solver2.setDistanceCache(&cache);
+  solver2.createDistanceTable();
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(solver2.pathDist(0), solver1.pathDist(0, P.getStart(1)));
+}
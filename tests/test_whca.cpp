@@ -11,3 +11,38 @@ TEST(WHCA, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(WHCA, reuse)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = WHCA(&P);
+  char* argv[] = {(char*)"", (char*)"-r"};
+  solver.setParams(2, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
+
+TEST(WHCA, reuse_kept_paths)
+{
+  // one agent moves over several windows, the others rest at goals
+  Problem P0 = Problem("../tests/instances/example.txt");
+  Graph* G = P0.getG();
+  Config starts = {G->getNode(5, 1), G->getNode(12, 28), G->getNode(9, 28),
+                   G->getNode(5, 20)};
+  Config goals = starts;
+  goals[0] = G->getNode(11, 7);
+  Problem P = Problem(G, starts, goals, 1000, 100);
+
+  auto solver = WHCA(&P);
+  char* argv[] = {(char*)"", (char*)"-r", (char*)"-w", (char*)"3"};
+  solver.setParams(4, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+  ASSERT_GT(solver.getPlannedNum(0), 1);
+  // kept paths are planned only in the first window
+  for (int i = 1; i < P.getNum(); ++i) ASSERT_EQ(solver.getPlannedNum(i), 1);
+}
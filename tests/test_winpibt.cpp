@@ -11,3 +11,15 @@ TEST(winPIBT, solve)
   ASSERT_TRUE(solver->succeed());
   ASSERT_TRUE(solver->getSolution().validate(&P));
 }
+
+TEST(winPIBT, no_window)
+{
+  Problem P = Problem("../tests/instances/example.txt");
+  auto solver = winPIBT(&P);
+  char* argv[] = {(char*)"", (char*)"-w", (char*)"-1"};
+  solver.setParams(3, argv);
+  solver.solve();
+
+  ASSERT_TRUE(solver.succeed());
+  ASSERT_TRUE(solver.getSolution().validate(&P));
+}
@@ -1,12 +1,16 @@
 #include "ofMain.h"
 #include "../include/ofApp.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <climits>
+#include <cstring>
 #include <iostream>
-#include <fstream>
-#include <regex>
 #include "../include/mapfplan.hpp"
 
 void readSetResult(const std::string& result_file, MAPFPlan* plan);
-void readSetNode(const std::string& s, Config& config, Grid* G);
+void readSetNode(const char* s, const char* e, Config& config, Grid* G);
 
 
 int main(int argc, char *argv[]) {
@@ -22,19 +26,42 @@ int main(int argc, char *argv[]) {
   return 0;
 }
 
-void readSetNode(const std::string& s, Config& config, Grid* G)
+// whole [s, e) is a non-negative integer
+static bool parseUInt(const char* s, const char* e, int& v)
+{
+  if (s == e) return false;
+  long long x = 0;
+  for (; s < e; ++s) {
+    if (*s < '0' || *s > '9') return false;
+    x = x * 10 + (*s - '0');
+    if (x > INT_MAX) return false;
+  }
+  v = (int)x;
+  return true;
+}
+
+// read digits from s, return the next position or nullptr
+static const char* readUInt(const char* s, const char* e, int& v)
+{
+  const char* p = s;
+  while (p < e && *p >= '0' && *p <= '9') ++p;
+  return parseUInt(s, p, v) ? p : nullptr;
+}
+
+void readSetNode(const char* s, const char* e, Config& config, Grid* G)
 {
   if (G == nullptr) {
     std::cout << "error@main, no graph" << std::endl;
     std::exit(1);
   }
-  std::regex r_pos = std::regex(R"(\((\d+),(\d+)\),)");
-  std::smatch m;
-  auto iter = s.cbegin();
-  while (std::regex_search(iter, s.cend(), m, r_pos)) {
-    iter = m[0].second;
-    int x = std::stoi(m[1].str());
-    int y = std::stoi(m[2].str());
+  // find "(x,y),"
+  int x, y;
+  while ((s = static_cast<const char*>(std::memchr(s, '(', e - s))) != nullptr) {
+    const char* p = readUInt(++s, e, x);
+    if (p == nullptr || p == e || *p != ',') continue;
+    p = readUInt(p + 1, e, y);
+    if (p == nullptr || e - p < 2 || p[0] != ')' || p[1] != ',') continue;
+    s = p + 2;
     if (!G->existNode(x, y)) {
       std::cout << "error@main, node does not exist" << std::endl;
       delete G;
@@ -46,81 +73,77 @@ void readSetNode(const std::string& s, Config& config, Grid* G)
 
 void readSetResult(const std::string& result_file, MAPFPlan* plan)
 {
-  std::ifstream file(result_file);
-  if (!file) {
+  // map the whole file, parsed in a single pass
+  const int fd = open(result_file.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
     std::cout << "error@main," << "file " << result_file << " is not found." << std::endl;
     std::exit(1);
   };
+  const size_t size = st.st_size;
+  const char* buf = nullptr;
+  if (size > 0) {
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      std::cout << "error@main," << "failed to read " << result_file << std::endl;
+      std::exit(1);
+    }
+    buf = static_cast<const char*>(p);
+  }
+  close(fd);
 
-  std::regex r_map       = std::regex(R"(map_file=(.+))");
-  std::regex r_agents    = std::regex(R"(agents=(.+))");
-  std::regex r_solver    = std::regex(R"(solver=(.+))");
-  std::regex r_solved    = std::regex(R"(solved=(\d))");
-  std::regex r_soc       = std::regex(R"(soc=(\d+))");
-  std::regex r_makespan  = std::regex(R"(makespan=(\d+))");
-  std::regex r_comp_time = std::regex(R"(comp_time=(\d+))");
-  std::regex r_starts    = std::regex(R"(starts=(.+))");
-  std::regex r_goals     = std::regex(R"(goals=(.+))");
-  std::regex r_sol       = std::regex(R"(solution=)");
-  std::regex r_config    = std::regex(R"(\d+:(.+))");
+  bool in_solution = false;
+  int v;
+  const char* const end = buf + size;
+  for (const char *l = buf, *e = l; l < end; l = e + 1) {
+    e = static_cast<const char*>(std::memchr(l, '\n', end - l));
+    if (e == nullptr) e = end;
+    const char* line_end = e;
+    if (line_end > l && *(line_end - 1) == 0x0d) --line_end;
 
-  std::string line;
-  std::smatch results;
-  while (getline(file, line)) {
-    // read map
-    if (std::regex_match(line, results, r_map)) {
-      plan->G = new Grid(results[1].str());  // deleted in destructor of MAPFPlan
-      continue;
-    }
-    // set agent num
-    if (std::regex_match(line, results, r_agents)) {
-      plan->num_agents = std::stoi(results[1].str());
-      continue;
-    }
-    // solver
-    if (std::regex_match(line, results, r_solver)) {
-      plan->solver = results[1].str();
-      continue;
-    }
-    // solved?
-    if (std::regex_match(line, results, r_solved)) {
-      plan->solved = (bool)std::stoi(results[1].str());
-      continue;
-    }
-    // soc
-    if (std::regex_match(line, results, r_soc)) {
-      plan->soc = std::stoi(results[1].str());
-      continue;
-    }
-    // makespan
-    if (std::regex_match(line, results, r_makespan)) {
-      plan->makespan = std::stoi(results[1].str());
-      continue;
-    }
-    // comp_time
-    if (std::regex_match(line, results, r_comp_time)) {
-      plan->comp_time = std::stoi(results[1].str());
-      continue;
-    }
-    // starts
-    if (std::regex_match(line, results, r_starts)) {
-      readSetNode(results[1].str(), plan->config_s, plan->G);
+    // solution, "t:(x,y),(x,y),..."
+    if (in_solution) {
+      const char* p = readUInt(l, line_end, v);
+      if (p != nullptr && line_end - p >= 2 && *p == ':') {
+        Config c;
+        readSetNode(p + 1, line_end, c, plan->G);
+        plan->transitions.push_back(c);
+      }
       continue;
     }
-    // goals
-    if (std::regex_match(line, results, r_goals)) {
-      readSetNode(results[1].str(), plan->config_g, plan->G);
+
+    // key=value
+    const char* eq = static_cast<const char*>(std::memchr(l, '=', line_end - l));
+    if (eq == nullptr) continue;
+    const std::string key(l, eq);
+    const char* val = eq + 1;
+    if (key == "solution") {
+      if (val == line_end) in_solution = true;
       continue;
     }
-    // solution
-    if (std::regex_match(line, results, r_sol)) {
-      while (getline(file, line)) {
-        if (std::regex_match(line, results, r_config)) {
-          Config c;
-          readSetNode(results[1].str(), c, plan->G);
-          plan->transitions.push_back(c);
-        }
-      }
+    if (val == line_end) continue;
+    if (key == "map_file") {
+      // read map
+      plan->G = new Grid(std::string(val, line_end));  // deleted in destructor of MAPFPlan
+    } else if (key == "agents") {
+      // set agent num
+      plan->num_agents = std::stoi(std::string(val, line_end));
+    } else if (key == "solver") {
+      plan->solver = std::string(val, line_end);
+    } else if (key == "solved") {
+      // solved?
+      if (line_end - val == 1 && parseUInt(val, line_end, v)) plan->solved = (bool)v;
+    } else if (key == "soc") {
+      if (parseUInt(val, line_end, v)) plan->soc = v;
+    } else if (key == "makespan") {
+      if (parseUInt(val, line_end, v)) plan->makespan = v;
+    } else if (key == "comp_time") {
+      if (parseUInt(val, line_end, v)) plan->comp_time = v;
+    } else if (key == "starts") {
+      readSetNode(val, line_end, plan->config_s, plan->G);
+    } else if (key == "goals") {
+      readSetNode(val, line_end, plan->config_g, plan->G);
     }
   }
+  if (buf != nullptr) munmap(const_cast<char*>(buf), size);
 }